@@ -0,0 +1,231 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "BatchModularizer.h"
+#include "TaskPool.h"
+#include "eFaCTPlusPlus.h"
+
+//-------------------------------------------------------------
+// BatchModularizer::Worker implementation
+//-------------------------------------------------------------
+
+BatchModularizer :: Worker :: Worker ( const SigIndex& index, ModuleMethod moduleMethod, const AxiomVec& axioms )
+	: Index(index)
+	, Compiled(index.getCompiledLocality())
+	, Checker(createLocalityChecker(moduleMethod,&Sig))
+	, Pass(0)
+	, restricted(false)
+	, nChecks(0)
+{
+	Checker->preprocessOntology(axioms);
+}
+
+/// add an axiom to a module
+void
+BatchModularizer :: Worker :: addAxiomToModule ( TDLAxiom* ax )
+{
+	mark ( InModule, ax, Pass );
+	Module.push_back(ax);
+	// update the signature
+	const TSignature& axiomSig = ax->getSignature();
+	for ( TSignature::iterator p = axiomSig.begin(), p_end = axiomSig.end(); p != p_end; ++p )
+		if ( !Sig.contains(*p) )	// new one
+		{
+			WorkQueue.push(*p);
+			Sig.add(*p);
+		}
+}
+
+/// process all the axioms affected by the ENTITY added to the signature
+void
+BatchModularizer :: Worker :: processEntity ( const TNamedEntity* entity )
+{
+	bool top = Sig.topCLocal();
+	const AxiomVec& axioms = Index.getAxioms(entity);
+	for ( AxiomVec::const_iterator p = axioms.begin(), p_end = axioms.end(); p != p_end; ++p )
+	{
+		if ( !isCandidate(*p) )
+			continue;
+		bool nonLocal;
+		if ( Compiled != nullptr && Compiled->isCompiled(*p,top) )
+			nonLocal = Compiled->addEntity ( *p, top, entity, State );
+		else
+		{
+			++nChecks;
+			nonLocal = !Checker->local(*p);
+		}
+		if ( nonLocal )
+			addNonLocal(*p);
+	}
+}
+
+/// extract module wrt SEED and top-locality value TOP starting from the module of BASE (if any); restrict it to RANGE (if any)
+void
+BatchModularizer :: Worker :: extract ( const TSignature& seed, bool top, const Worker* base, const AxiomVec* range )
+{
+	++Pass;
+	restricted = range != nullptr;
+	if ( restricted )
+		for ( AxiomVec::const_iterator p = range->begin(), p_end = range->end(); p != p_end; ++p )
+			mark ( InRange, *p, Pass );
+
+	if ( base != nullptr )
+	{	// start from the module of the empty signature and the counters it left
+		fpp_assert ( !restricted && base->Sig.topCLocal() == top );
+		Sig = base->Sig;
+		Module = base->Module;
+		for ( AxiomVec::const_iterator p = Module.begin(), p_end = Module.end(); p != p_end; ++p )
+			mark ( InModule, *p, Pass );
+		State.newPass(&base->State);
+		for ( TSignature::iterator p = seed.begin(), p_end = seed.end(); p != p_end; ++p )
+			if ( !Sig.contains(*p) )
+			{
+				WorkQueue.push(*p);
+				Sig.add(*p);
+			}
+	}
+	else
+	{
+		Sig = seed;
+		Sig.setLocality(top);
+		Module.clear();
+		State.newPass();
+		for ( TSignature::iterator p = Sig.begin(), p_end = Sig.end(); p != p_end; ++p )
+			WorkQueue.push(*p);
+		// add all the axioms that are non-local wrt given value of a top-locality
+		const AxiomVec& nonLocal = Index.getNonLocal(top);
+		for ( AxiomVec::const_iterator p = nonLocal.begin(), p_end = nonLocal.end(); p != p_end; ++p )
+			if ( isCandidate(*p) )
+				addNonLocal(*p);
+	}
+
+	// main cycle
+	while ( !WorkQueue.empty() )
+	{
+		const TNamedEntity* entity = WorkQueue.front();
+		WorkQueue.pop();
+		processEntity(entity);
+	}
+}
+
+/// extract module wrt SIGNATURE and TYPE; use modules of the empty signature BASE for top- and bot-localities
+void
+BatchModularizer :: Worker :: extract ( const TSignature& signature, ModuleType type, Worker* const base[2] )
+{
+	bool topLocality = (type == M_TOP);
+	extract ( signature, topLocality, base[topLocality], nullptr );
+
+	if ( type != M_STAR )
+		return;
+
+	// here there is a star: do the cycle until stabilization
+	size_t size;
+	AxiomVec oldModule;
+	do
+	{
+		size = Module.size();
+		oldModule.swap(Module);
+		topLocality = !topLocality;
+		extract ( signature, topLocality, nullptr, &oldModule );
+	} while ( size != Module.size() );
+}
+
+//-------------------------------------------------------------
+// BatchModularizer implementation
+//-------------------------------------------------------------
+
+BatchModularizer :: ~BatchModularizer ( void )
+{
+	for ( auto& worker: Workers )
+		delete worker;
+	delete Base[0];
+	delete Base[1];
+	delete Pool;
+}
+
+/// extract modules of TYPE for all SIGNATURES into MODULES using up to NTHREADS threads
+void
+BatchModularizer :: extract ( const std::vector<TSignature>& signatures, ModuleType type, std::vector<AxiomVec>& modules, unsigned int nThreads )
+{
+	modules.assign ( signatures.size(), AxiomVec() );
+	if ( signatures.empty() )
+		return;
+
+	// signature-independent part: the module of the empty signature
+	bool top = (type == M_TOP);
+	if ( Base[top] == nullptr )
+	{
+		Base[top] = newWorker();
+		Base[top]->extract ( TSignature(), top, nullptr, nullptr );
+	}
+
+	// semantic locality checkers are full reasoners, so keep them in one thread
+	if ( Modularizer.getModuleMethod() == SEM_LOC )
+		nThreads = 1;
+	if ( Workers.empty() )
+		Workers.push_back(newWorker());
+
+	if ( nThreads <= 1 || signatures.size() == 1 )
+	{
+		for ( size_t i = 0; i < signatures.size(); ++i )
+		{
+			Workers[0]->extract ( signatures[i], type, Base );
+			modules[i] = Workers[0]->getModule();
+		}
+		return;
+	}
+
+	// re-create the pool if the number of threads changed
+	if ( Pool != nullptr && Pool->size() != nThreads )
+	{
+		delete Pool;
+		Pool = nullptr;
+	}
+	if ( Pool == nullptr )
+		Pool = new TaskPool(nThreads);
+	while ( Workers.size() < nThreads )
+		Workers.push_back(newWorker());
+
+	// NOTE: the index and the base modules are read-only while the tasks are running
+	for ( size_t i = 0; i < signatures.size(); ++i )
+		Pool->submit ( [this,i,type,&signatures,&modules] ( unsigned int w )
+		{
+			Workers[w]->extract ( signatures[i], type, Base );
+			modules[i] = Workers[w]->getModule();
+		} );
+	// a dropped task leaves its module empty, so a partial result can't be returned
+	unsigned long nTimeouts = Pool->getNumTimeouts();
+	if ( !Pool->wait() || Pool->getNumTimeouts() != nTimeouts )
+	{
+		modules.assign ( signatures.size(), AxiomVec() );
+		throw EFaCTPlusPlus("FaCT++ Kernel: module extraction was interrupted");
+	}
+}
+
+/// get number of locality checks made by all extractions
+unsigned long long
+BatchModularizer :: getNChecks ( void ) const
+{
+	unsigned long long ret = 0;
+	for ( const auto& worker: Workers )
+		ret += worker->getNChecks();
+	for ( const auto& base: Base )
+		if ( base != nullptr )
+			ret += base->getNChecks();
+	return ret;
+}
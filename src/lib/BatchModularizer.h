@@ -0,0 +1,155 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef BATCHMODULARIZER_H
+#define BATCHMODULARIZER_H
+
+#include "Modularity.h"
+
+class TaskPool;
+
+/**
+ * Extractor of modules for many signatures at once. Modules are monotone in
+ * the signature, so the module of the empty signature (that contains all the
+ * globally non-local axioms) is built once per locality class and every
+ * extraction starts from it, together with the locality counters it left.
+ * Extractions keep their state outside the axioms and the shared index,
+ * so they could run in parallel.
+ */
+class BatchModularizer
+{
+protected:	// types
+		/// extraction context; it is used by one thread at a time
+	class Worker
+	{
+	protected:	// members
+			/// index of the axioms
+		const SigIndex& Index;
+			/// compiled locality of the axioms (if any)
+		const CompiledLocality* Compiled;
+			/// signature of the current module
+		TSignature Sig;
+			/// locality checker for the axioms with no compiled locality
+		LocalityChecker* Checker;
+			/// module as a list of axioms
+		AxiomVec Module;
+			/// pass in which an axiom was added to the module; indexed by axiom ids
+		std::vector<unsigned int> InModule;
+			/// pass in which an axiom was in the range; indexed by axiom ids
+		std::vector<unsigned int> InRange;
+			/// current pass
+		unsigned int Pass;
+			/// true iff the extraction is restricted to a range
+		bool restricted;
+			/// counters of the compiled locality conditions
+		CompiledLocality::PassState State;
+			/// queue of unprocessed entities
+		std::queue<const TNamedEntity*> WorkQueue;
+			/// number of locality check calls
+		unsigned long long nChecks;
+
+	protected:	// methods
+			/// set STAMP for the axiom AX in the vector V
+		static void mark ( std::vector<unsigned int>& v, const TDLAxiom* ax, unsigned int stamp )
+		{
+			if ( ax->getId() >= v.size() )
+				v.resize ( ax->getId()+1, 0 );
+			v[ax->getId()] = stamp;
+		}
+			/// @return true iff AX is marked by the current pass in V
+		bool isMarked ( const std::vector<unsigned int>& v, const TDLAxiom* ax ) const
+			{ return ax->getId() < v.size() && v[ax->getId()] == Pass; }
+			/// @return true iff AX could be added to the module
+		bool isCandidate ( const TDLAxiom* ax ) const
+			{ return !isMarked ( InModule, ax ) && ( !restricted || isMarked ( InRange, ax ) ); }
+			/// add an axiom to a module
+		void addAxiomToModule ( TDLAxiom* ax );
+			/// add the candidate axiom AX and (the rest of) its atom's module
+		void addNonLocal ( TDLAxiom* ax )
+		{
+			addAxiomToModule(ax);
+#		ifdef RKG_USE_AD_IN_MODULE_EXTRACTION
+			if ( ax->getAtom() != nullptr )
+				for ( const auto& p: ax->getAtom()->getModule() )
+					if ( isCandidate(p) )
+						addAxiomToModule(p);
+#		endif
+		}
+			/// process all the axioms affected by the ENTITY added to the signature
+		void processEntity ( const TNamedEntity* entity );
+
+	public:		// interface
+			/// init c'tor
+		Worker ( const SigIndex& index, ModuleMethod moduleMethod, const AxiomVec& axioms );
+			/// no copy c'tor
+		Worker ( const Worker& ) = delete;
+			/// no assignment
+		Worker& operator = ( const Worker& ) = delete;
+			/// d'tor
+		~Worker ( void ) { delete Checker; }
+
+			/// extract module wrt SEED and top-locality value TOP starting from the module of BASE (if any); restrict it to RANGE (if any)
+		void extract ( const TSignature& seed, bool top, const Worker* base, const AxiomVec* range );
+			/// extract module wrt SIGNATURE and TYPE; use modules of the empty signature BASE for top- and bot-localities
+		void extract ( const TSignature& signature, ModuleType type, Worker* const base[2] );
+
+			/// get the last computed module
+		const AxiomVec& getModule ( void ) const { return Module; }
+			/// get number of checks made
+		unsigned long long getNChecks ( void ) const { return nChecks; }
+	}; // Worker
+
+protected:	// members
+		/// modularizer that keeps the axiom index
+	const TModularizer& Modularizer;
+		/// axioms to extract modules from
+	const AxiomVec& Axioms;
+		/// extraction contexts; one per pool worker
+	std::vector<Worker*> Workers;
+		/// pool of worker threads (if any)
+	TaskPool* Pool;
+		/// modules of the empty signature for bot- (index 0) and top-locality (index 1)
+	Worker* Base[2];
+
+protected:	// methods
+		/// @return new extraction context
+	Worker* newWorker ( void ) const { return new Worker ( Modularizer.getSigIndex(), Modularizer.getModuleMethod(), Axioms ); }
+
+public:		// interface
+		/// init c'tor: use the index of the MODULARIZER preprocessed with AXIOMS
+	BatchModularizer ( const TModularizer& modularizer, const AxiomVec& axioms )
+		: Modularizer(modularizer)
+		, Axioms(axioms)
+		, Pool(nullptr)
+	{
+		Base[0] = Base[1] = nullptr;
+	}
+		/// no copy c'tor
+	BatchModularizer ( const BatchModularizer& ) = delete;
+		/// no assignment
+	BatchModularizer& operator = ( const BatchModularizer& ) = delete;
+		/// d'tor
+	~BatchModularizer ( void );
+
+		/// extract modules of TYPE for all SIGNATURES into MODULES using up to NTHREADS threads
+	void extract ( const std::vector<TSignature>& signatures, ModuleType type, std::vector<AxiomVec>& modules, unsigned int nThreads = 1 );
+		/// get number of locality checks made by all extractions
+	unsigned long long getNChecks ( void ) const;
+}; // BatchModularizer
+
+#endif
@@ -285,7 +285,8 @@ bool DlCompletionTree :: B3 ( const DlCompletionTree* p, unsigned int n, const T
 	else
 	{	// ...and <=n-1 S-succ. z with C\in L(z)
 		unsigned int m = 0;
-		for ( const_edge_iterator q = p->begin(), q_end = p->end(); q < q_end; ++q )
+		EdgeRange edges = p->neighbours(S);
+		for ( const_edge_iterator q = edges.begin(), q_end = edges.end(); q < q_end; ++q )
 			if ( (*q)->isSuccEdge() && (*q)->isNeighbour(S) && (*q)->getArcEnd()->isLabelledBy(C) )
 				++m;
 
@@ -314,7 +315,8 @@ bool DlCompletionTree :: B4 ( const DlCompletionTree* p, unsigned int m, const T
 	// a) w' has at least m T-succ z with E\in L(z)
 	// check all sons
 	unsigned int n = 0;
-	for ( const_edge_iterator q = p->begin(), q_end = p->end(); q < q_end; ++q )
+	EdgeRange edges = p->neighbours(T);
+	for ( const_edge_iterator q = edges.begin(), q_end = edges.end(); q < q_end; ++q )
 		if ( (*q)->isSuccEdge() && (*q)->isNeighbour(T) && (*q)->getArcEnd()->isLabelledBy(E) )
 			if ( ++n >= m )		// check if node has enough successors
 				return true;
@@ -373,6 +375,9 @@ bool DlCompletionTree :: B6 ( const TRole* U, BipolarPointer F ) const
 
 void DlCompletionGraph :: detectBlockedStatus ( DlCompletionTree* node )
 {
+	// blocking re-checks of a large graph might take long
+	pReasoner->checkDeadline();
+
 	DlCompletionTree* p = node;
 	bool wasBlocked = node->isBlocked();
 	bool wasDBlocked = node->isDBlocked();
@@ -430,6 +435,9 @@ void DlCompletionGraph :: findDAncestorBlocker ( DlCompletionTree* node )
 
 void DlCompletionGraph :: findDAnywhereBlocker ( DlCompletionTree* node )
 {
+	// the scan is linear in the size of the graph
+	pReasoner->checkDeadline();
+
 	for ( const_iterator q = begin(), q_end = end(); q < q_end && *q != node; ++q )
 	{
 		const DlCompletionTree* p = *q;
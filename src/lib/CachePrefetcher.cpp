@@ -0,0 +1,120 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "CachePrefetcher.h"
+#include "Reasoner.h"
+#include "TaskPool.h"
+
+CachePrefetcher :: ~CachePrefetcher ( void )
+{
+	for ( auto& task: Tasks )
+		delete task.cache;
+}
+
+/// run the TASK using the reasoner WORKER
+void
+CachePrefetcher :: runTask ( DlSatTester* worker, Task& task )
+{
+	// timeouts and cancellation will be re-discovered by the main reasoner if necessary
+	worker->setBlockingMethod ( task.hasInverse, task.hasQCR );
+	bool sat = worker->runSat(task.bp);
+	// a cancelled test says nothing about satisfiability: leave the cache to the main reasoner
+	if ( !worker->isCancelled() )
+		task.cache = worker->buildCacheByCGraph(sat);
+}
+
+/// build all the scheduled caches and register them in the DAG; the call returns when all tasks are done
+void
+CachePrefetcher :: run ( void )
+{
+	// NOTE: the DAG is read-only while the tasks are running: the new caches are registered after all of them are done
+	TaskPool& pool = tBox.getTaskPool();
+	for ( auto& task: Tasks )
+	{
+		Task* t = &task;
+		pool.submit ( [this,t] ( unsigned int i ) { runTask ( tBox.getPoolReasoner(i), *t ); } );
+	}
+	// the cancellation might have come after some task finished its test, so drop all the caches
+	bool done = pool.wait();
+
+	// register caches
+	for ( auto& task: Tasks )
+	{
+		if ( task.cache == nullptr )
+			continue;
+		if ( done && tBox.DLHeap.getCache(task.bp) == nullptr )
+		{
+			tBox.DLHeap.setCache ( task.bp, task.cache );
+			++nPrefetched;
+		}
+		else	// built by some other means or cancelled
+			delete task.cache;
+	}
+
+	Tasks.clear();
+}
+
+//-----------------------------------------------------------------------------
+//--		implemenation of prefetch-related parts of TBox
+//-----------------------------------------------------------------------------
+
+/// schedule the cache for C (or ~C if SUB) for the parallel construction
+void
+TBox :: schedulePrefetch ( const TConcept* C, bool sub )
+{
+	BipolarPointer bp = sub ? inverse(C->pName) : C->pName;
+	if ( DLHeap.getCache(bp) != nullptr )
+		return;
+
+	if ( sub )
+		prepareFeatures ( nullptr, C );
+	else
+		prepareFeatures ( C, nullptr );
+	// nominal reasoner changes the individuals, so it can't be used in parallel
+	if ( !curFeature->hasSingletons() )
+		pPrefetcher->add ( bp, isIRinQuery(), isNRinQuery() );
+	clearFeatures();
+}
+
+/// build missing caches for the unclassified concepts in [BEGIN,END) in parallel; @return the end of the processed part
+TBox::ConceptVector::const_iterator
+TBox :: prefetchCaches ( ConceptVector::const_iterator begin, ConceptVector::const_iterator end )
+{
+	fpp_assert ( pPrefetcher != nullptr );
+
+	// take a few tasks per worker to amortise the synchronisation with the pool
+	for ( unsigned int n = 0; begin != end && n < 4*nCacheThreads; ++begin )
+	{
+		const TConcept* C = *begin;
+		if ( C->isClassified() || C->isSingleton() )
+			continue;
+		++n;
+		// these are the caches used during the classification of C (see immediatelyClassified() and isEqualToTop())
+		if ( C->getClassTag() != cttTrueCompletelyDefined )
+			schedulePrefetch ( C, /*sub=*/false );
+		schedulePrefetch ( C, /*sub=*/true );
+	}
+
+	// leave single tests to the usual (cascaded) cache construction
+	if ( pPrefetcher->worthRunning() )
+		pPrefetcher->run();
+	else
+		pPrefetcher->clear();
+
+	return begin;
+}
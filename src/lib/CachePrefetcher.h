@@ -0,0 +1,92 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef CACHEPREFETCHER_H
+#define CACHEPREFETCHER_H
+
+#include <vector>
+
+#include "BiPointer.h"
+
+class TBox;
+class DlSatTester;
+class modelCacheInterface;
+
+/// build model caches for a batch of DAG entries in parallel, using the TBox's pool of workers
+class CachePrefetcher
+{
+protected:	// types
+		/// single cache construction task
+	struct Task
+	{
+			/// DAG entry to build the cache for
+		BipolarPointer bp;
+			/// blocking method: whether inverse roles are present
+		bool hasInverse;
+			/// blocking method: whether number restrictions are present
+		bool hasQCR;
+			/// the cache built (if any)
+		const modelCacheInterface* cache;
+			/// init c'tor
+		Task ( BipolarPointer p, bool inv, bool qcr ) : bp(p), hasInverse(inv), hasQCR(qcr), cache(nullptr) {}
+	}; // Task
+		/// vector of tasks
+	typedef std::vector<Task> TaskVector;
+
+protected:	// members
+		/// host TBox
+	TBox& tBox;
+		/// tasks of the current batch
+	TaskVector Tasks;
+		/// number of caches built in parallel
+	unsigned long nPrefetched;
+
+protected:	// methods
+		/// run the TASK using the reasoner WORKER
+	static void runTask ( DlSatTester* worker, Task& task );
+
+public:		// interface
+		/// init c'tor: use the pool of TBOX
+	explicit CachePrefetcher ( TBox& tbox ) : tBox(tbox), nPrefetched(0) {}
+		/// no copy c'tor
+	CachePrefetcher ( const CachePrefetcher& ) = delete;
+		/// no assignment
+	CachePrefetcher& operator = ( const CachePrefetcher& ) = delete;
+		/// d'tor
+	~CachePrefetcher ( void );
+
+		/// schedule cache construction for BP with a given blocking method
+	void add ( BipolarPointer bp, bool hasInverse, bool hasQCR )
+	{
+		for ( const auto& task: Tasks )
+			if ( task.bp == bp )
+				return;
+		Tasks.push_back(Task(bp,hasInverse,hasQCR));
+	}
+		/// @return true iff there is something to do in parallel
+	bool worthRunning ( void ) const { return Tasks.size() > 1; }
+		/// build all the scheduled caches and register them in the DAG; the call returns when all tasks are done
+	void run ( void );
+		/// drop all the scheduled tasks
+	void clear ( void ) { Tasks.clear(); }
+
+		/// @return number of caches built in parallel
+	unsigned long getNumPrefetched ( void ) const { return nPrefetched; }
+}; // CachePrefetcher
+
+#endif
@@ -36,7 +36,18 @@ DlSatTester :: createCache ( BipolarPointer p )
 	std::cerr << "\nCCache for " << p << ":";
 #endif
 	if ( !unlikely(tBox.testHasTopRole()) )
-		prepareCascadedCache(p);
+	{
+		try
+		{
+			prepareCascadedCache(p);
+		}
+		catch(...)
+		{
+			// timeouts abort the whole cascade, so don't leave stale cycle marks for the next one
+			inProcess.clear();
+			throw;
+		}
+	}
 
 	// it may be a cycle and the cache for p is already calculated
 	if ( (cache = DLHeap.getCache(p)) != nullptr )
@@ -50,6 +61,9 @@ DlSatTester :: createCache ( BipolarPointer p )
 void
 DlSatTester :: prepareCascadedCache ( BipolarPointer p )
 {
+	// cascade might be long even if every test is short
+	checkDeadline();
+
 	/// cycle found -- shall be processed without caching
 	if ( inProcess.find(p) != inProcess.end() )
 	{
@@ -0,0 +1,157 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <iterator>
+
+#include "CompiledLocality.h"
+
+//-------------------------------------------------------------
+// SigCondition implementation
+//-------------------------------------------------------------
+
+void
+SigCondition :: addClause ( const Clause& c )
+{
+	// C is redundant if some clause is a subset of it
+	for ( ClauseVec::const_iterator p = Clauses.begin(), p_end = Clauses.end(); p != p_end; ++p )
+		if ( std::includes ( c.begin(), c.end(), p->begin(), p->end() ) )
+			return;
+	// remove all the clauses that are supersets of C
+	Clauses.erase ( std::remove_if ( Clauses.begin(), Clauses.end(),
+		[&c] ( const Clause& p ) { return std::includes ( p.begin(), p.end(), c.begin(), c.end() ); } ),
+		Clauses.end() );
+	if ( Clauses.size() >= MaxClauses )
+		invalidate();
+	else
+		Clauses.push_back(c);
+}
+
+SigCondition&
+SigCondition :: operator |= ( const SigCondition& c )
+{
+	if ( !isValid() || !c.isValid() )
+		invalidate();
+	else
+		for ( ClauseVec::const_iterator p = c.Clauses.begin(), p_end = c.Clauses.end(); p != p_end && isValid(); ++p )
+			addClause(*p);
+	return *this;
+}
+
+SigCondition&
+SigCondition :: operator &= ( const SigCondition& c )
+{
+	if ( !isValid() || !c.isValid() )
+	{
+		invalidate();
+		return *this;
+	}
+	if ( isFalse() || c.isTrue() )
+		return *this;
+	ClauseVec old;
+	old.swap(Clauses);
+	Clause merged;
+	// distribute the conjunction over the clauses
+	for ( ClauseVec::const_iterator p = old.begin(), p_end = old.end(); p != p_end && isValid(); ++p )
+		for ( ClauseVec::const_iterator q = c.Clauses.begin(), q_end = c.Clauses.end(); q != q_end && isValid(); ++q )
+		{
+			merged.clear();
+			std::set_union ( p->begin(), p->end(), q->begin(), q->end(), std::back_inserter(merged) );
+			addClause(merged);
+		}
+	return *this;
+}
+
+//-------------------------------------------------------------
+// CompiledLocality implementation
+//-------------------------------------------------------------
+
+void
+CompiledLocality :: init ( Condition& cond, const SigCondition& c )
+{
+	cond.Entities.clear();
+	cond.Ends.clear();
+	cond.First = nClauses;
+	cond.Compiled = c.isValid();
+	if ( !cond.Compiled )
+		return;
+	const SigCondition::ClauseVec& clauses = c.getClauses();
+	for ( SigCondition::ClauseVec::const_iterator p = clauses.begin(), p_end = clauses.end(); p != p_end; ++p )
+	{
+		cond.Entities.insert ( cond.Entities.end(), p->begin(), p->end() );
+		cond.Ends.push_back(static_cast<unsigned int>(cond.Entities.size()));
+	}
+	nClauses += static_cast<unsigned int>(cond.Ends.size());
+}
+
+void
+CompiledLocality :: registerAx ( const TDLAxiom* ax )
+{
+	unsigned int id = ax->getId();
+	if ( id >= Base.size() )
+		Base.resize(id+1);
+	Entry& entry = Base[id];
+	entry.Axiom = ax;
+	LocalityCompiler topCompiler ( /*topC=*/true, /*topR=*/true );
+	init ( entry.Cond[0], topCompiler.compile(ax) );
+	LocalityCompiler botCompiler ( /*topC=*/false, /*topR=*/false );
+	init ( entry.Cond[1], botCompiler.compile(ax) );
+}
+
+bool
+CompiledLocality :: addEntity ( const TDLAxiom* ax, bool top, const TNamedEntity* entity, PassState& state ) const
+{
+	const Condition& cond = getEntry(ax)->Cond[!top];
+	size_t nCond = cond.Ends.size();
+	size_t index = 2*ax->getId() + !top;
+
+	if ( state.Stamp.size() <= index )
+		state.Stamp.resize ( 2*Base.size(), 0 );
+	if ( state.Counters.size() < nClauses )
+		state.Counters.resize ( nClauses, 0 );
+	unsigned int* counters = state.Counters.data() + cond.First;
+
+	// 1st touch in this pass: take the counters from the initial state or start with all the entities missing
+	if ( state.Stamp[index] != state.Pass )
+	{
+		state.Stamp[index] = state.Pass;
+		const PassState* init = state.Init;
+		if ( init != nullptr && index < init->Stamp.size() && init->Stamp[index] == init->Pass )
+			std::copy ( init->Counters.begin()+cond.First, init->Counters.begin()+cond.First+nCond, counters );
+		else
+		{
+			unsigned int begin = 0;
+			for ( size_t i = 0; i < nCond; ++i )
+			{
+				counters[i] = cond.Ends[i] - begin;
+				begin = cond.Ends[i];
+			}
+		}
+	}
+
+	bool nonLocal = false;
+	unsigned int begin = 0;
+	for ( size_t i = 0; i < nCond; ++i )
+	{
+		unsigned int end = cond.Ends[i];
+		if ( std::binary_search ( cond.Entities.begin()+begin, cond.Entities.begin()+end, entity ) && --counters[i] == 0 )
+			nonLocal = true;
+		begin = end;
+	}
+	return nonLocal;
+}
@@ -0,0 +1,488 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef COMPILEDLOCALITY_H
+#define COMPILEDLOCALITY_H
+
+#include <vector>
+
+#include "tDLAxiom.h"
+#include "tDataTypeManager.h"
+
+/**
+ * Monotone condition over a signature: a disjunction of conjunctions (clauses) of entities.
+ * The condition holds wrt a signature iff all the entities of some clause are in the signature.
+ * Conditions that grow too large become invalid, i.e., they could not be used for the decision.
+ */
+class SigCondition
+{
+public:		// types
+		/// conjunction of entities; kept sorted
+	typedef std::vector<const TNamedEntity*> Clause;
+		/// disjunction of clauses
+	typedef std::vector<Clause> ClauseVec;
+
+protected:	// members
+		/// clauses of the condition; no clause is a subset of another one
+	ClauseVec Clauses;
+		/// false if the condition could not be represented
+	bool Valid;
+
+protected:	// methods
+		/// add clause C to the disjunction wrt absorption
+	void addClause ( const Clause& c );
+		/// make the condition invalid
+	void invalidate ( void ) { Clauses.clear(); Valid = false; }
+
+public:		// interface
+		/// c'tor: create a constant condition
+	explicit SigCondition ( bool value = false ) : Valid(true)
+	{
+		if ( value )
+			Clauses.push_back(Clause());
+	}
+		/// c'tor: create a condition that holds iff ENTITY is in the signature
+	explicit SigCondition ( const TNamedEntity* entity ) : Clauses(1,Clause(1,entity)), Valid(true) {}
+
+		/// @return the condition that could not be represented
+	static SigCondition invalid ( void ) { SigCondition ret; ret.Valid = false; return ret; }
+
+		/// max number of clauses in a valid condition
+	static const size_t MaxClauses = 256;
+
+	// access to the value
+
+		/// @return true iff the condition could be used
+	bool isValid ( void ) const { return Valid; }
+		/// @return true iff the condition holds wrt every signature
+	bool isTrue ( void ) const { return Valid && Clauses.size() == 1 && Clauses.front().empty(); }
+		/// @return true iff the condition never holds
+	bool isFalse ( void ) const { return Valid && Clauses.empty(); }
+		/// get all the clauses
+	const ClauseVec& getClauses ( void ) const { return Clauses; }
+
+	// operations
+
+		/// disjunction with the condition C
+	SigCondition& operator |= ( const SigCondition& c );
+		/// conjunction with the condition C
+	SigCondition& operator &= ( const SigCondition& c );
+}; // SigCondition
+
+/// @return disjunction of the conditions A and B
+inline SigCondition operator | ( SigCondition a, const SigCondition& b ) { return a |= b; }
+/// @return conjunction of the conditions A and B
+inline SigCondition operator & ( SigCondition a, const SigCondition& b ) { return a &= b; }
+
+/**
+ * Compiler of the syntactic locality of axioms into conditions over a signature.
+ * It mirrors SyntacticLocalityChecker, but instead of answering whether an expression
+ * is bot- or top-equivalent wrt a given signature it builds the conditions under which
+ * it is NOT so. For the fixed locality class these conditions are monotone, so an axiom
+ * is non-local wrt a signature iff the compiled condition holds for it.
+ */
+class LocalityCompiler: public DLExpressionVisitorEmpty, public DLAxiomVisitor
+{
+protected:	// types
+		/// conditions that make an expression not bot- resp. top-equivalent
+	struct ExprConditions
+	{
+		SigCondition NotBot, NotTop;
+		ExprConditions ( const SigCondition& nb, const SigCondition& nt ) : NotBot(nb), NotTop(nt) {}
+	}; // ExprConditions
+
+protected:	// members
+		/// true iff concepts not in the signature are treated as TOPs
+	bool topC;
+		/// true iff roles not in the signature are treated as TOPs
+	bool topR;
+		/// conditions of the last visited expression
+	ExprConditions Expr;
+		/// non-locality condition of the last visited axiom
+	SigCondition NonLocal;
+
+protected:	// methods
+		/// @return conditions of the expression EXPR
+	ExprConditions get ( const TDLExpression* expr )
+	{
+		Expr = ExprConditions ( SigCondition::invalid(), SigCondition::invalid() );
+		expr->accept(*this);
+		return Expr;
+	}
+		/// @return condition that makes EXPR not bot-equivalent
+	SigCondition notBot ( const TDLExpression* expr ) { return get(expr).NotBot; }
+		/// @return condition that makes EXPR not top-equivalent
+	SigCondition notTop ( const TDLExpression* expr ) { return get(expr).NotTop; }
+		/// set conditions for the named entity with the locality class TOP
+	void setEntity ( const TNamedEntity* entity, bool top )
+	{
+		if ( top )
+			Expr = ExprConditions ( SigCondition(true), SigCondition(entity) );
+		else
+			Expr = ExprConditions ( SigCondition(entity), SigCondition(true) );
+	}
+		/// set constant conditions for the expression being bot-equivalent iff BOT and top-equivalent iff TOP
+	void setConst ( bool bot, bool top ) { Expr = ExprConditions ( SigCondition(!bot), SigCondition(!top) ); }
+
+		/// @return condition for #C^I <= n, i.e., negation of isCardLargerThan()
+	SigCondition notCardLargerThan ( const TDLExpression* C, unsigned int n )
+	{
+		if ( const TDLDataTypeName* namedDT = dynamic_cast<const TDLDataTypeName*>(C) )
+		{
+			if ( n == 0 )	// built-in DT are non-empty
+				return SigCondition(false);
+			// string/time are infinite DT
+			return SigCondition ( !isStrDataType(namedDT) && !isTimeDataType(namedDT) );
+		}
+		if ( n == 0 || dynamic_cast<const TDLDataExpression*>(C) )
+			return notTop(C);
+		return SigCondition(true);
+	}
+		/// @return condition for (>= n R.C) being not botEq
+	SigCondition notMinBot ( unsigned int n, const TDLExpression* R, const TDLExpression* C )
+		{ return n == 0 ? SigCondition(true) : notBot(R) & notBot(C); }
+		/// @return condition for (<= n R.C) being not botEq
+	SigCondition notMaxBot ( unsigned int n, const TDLExpression* R, const TDLExpression* C )
+		{ return notTop(R) | notCardLargerThan ( C, n ); }
+		/// @return condition for (>= n R.C) being not topEq
+	SigCondition notMinTop ( unsigned int n, const TDLExpression* R, const TDLExpression* C )
+		{ return n == 0 ? SigCondition(false) : notTop(R) | notCardLargerThan ( C, n-1 ); }
+		/// @return condition for (<= n R.C) being not topEq
+	SigCondition notMaxTop ( const TDLExpression* R, const TDLExpression* C ) { return notBot(R) & notBot(C); }
+
+		/// set conditions of the min-cardinality restriction
+	void setMin ( unsigned int n, const TDLExpression* R, const TDLExpression* C )
+		{ Expr = ExprConditions ( notMinBot ( n, R, C ), notMinTop ( n, R, C ) ); }
+		/// set conditions of the max-cardinality restriction
+	void setMax ( unsigned int n, const TDLExpression* R, const TDLExpression* C )
+		{ Expr = ExprConditions ( notMaxBot ( n, R, C ), notMaxTop ( R, C ) ); }
+		/// set conditions of the exact-cardinality restriction
+	void setExact ( unsigned int n, const TDLExpression* R, const TDLExpression* C )
+	{
+		Expr = ExprConditions ( notMinBot ( n, R, C ) & notMaxBot ( n, R, C ),
+								notMinTop ( n, R, C ) | notMaxTop ( R, C ) );
+	}
+		/// set conditions of the intersection of [BEG,END)
+	template<class Iterator>
+	void setAnd ( Iterator beg, Iterator end )
+	{
+		SigCondition nb(true), nt(false);
+		for ( ; beg != end; ++beg )
+		{
+			ExprConditions arg = get(*beg);
+			nb &= arg.NotBot;
+			nt |= arg.NotTop;
+		}
+		Expr = ExprConditions ( nb, nt );
+	}
+		/// set conditions of the union of [BEG,END)
+	template<class Iterator>
+	void setOr ( Iterator beg, Iterator end )
+	{
+		SigCondition nb(false), nt(true);
+		for ( ; beg != end; ++beg )
+		{
+			ExprConditions arg = get(*beg);
+			nb |= arg.NotBot;
+			nt &= arg.NotTop;
+		}
+		Expr = ExprConditions ( nb, nt );
+	}
+		/// set conditions of the negation of C
+	void setNot ( const TDLExpression* C )
+	{
+		ExprConditions arg = get(C);
+		Expr = ExprConditions ( arg.NotTop, arg.NotBot );
+	}
+
+		/// non-locality of the Equivalent axioms: local iff all the elements are bot-eq or all are top-eq
+	template<class Entity>
+	void processEquivalentAxiom ( const TDLNAryExpression<Entity>& axiom )
+	{
+		if ( axiom.size() <= 1 )
+		{
+			NonLocal = SigCondition(false);
+			return;
+		}
+		SigCondition nb(false), nt(false);
+		for ( typename TDLNAryExpression<Entity>::iterator p = axiom.begin(), p_end = axiom.end(); p != p_end; ++p )
+		{
+			ExprConditions arg = get(*p);
+			nb |= arg.NotBot;
+			nt |= arg.NotTop;
+		}
+		NonLocal = nb & nt;
+	}
+		/// non-locality of the Disjoint axioms: local iff at most 1 element is not bot-eq
+	template<class Entity>
+	void processDisjointAxiom ( const TDLNAryExpression<Entity>& axiom )
+	{
+		std::vector<SigCondition> args;
+		for ( typename TDLNAryExpression<Entity>::iterator p = axiom.begin(), p_end = axiom.end(); p != p_end; ++p )
+			args.push_back(notBot(*p));
+		NonLocal = SigCondition(false);
+		for ( size_t i = 0; i < args.size(); ++i )
+			for ( size_t j = i+1; j < args.size(); ++j )
+				NonLocal |= args[i] & args[j];
+	}
+
+public:		// interface
+		/// init c'tor: compile wrt the locality class given by TOPC and TOPR
+	LocalityCompiler ( bool topc, bool topr )
+		: topC(topc)
+		, topR(topr)
+		, Expr ( SigCondition::invalid(), SigCondition::invalid() )
+		{}
+		/// empty d'tor
+	virtual ~LocalityCompiler ( void ) {}
+
+		/// @return condition under which AXIOM is non-local
+	SigCondition compile ( const TDLAxiom* axiom )
+	{
+		NonLocal = SigCondition::invalid();
+		axiom->accept(*this);
+		return NonLocal;
+	}
+
+public:		// expression visitor interface
+	// concept expressions
+	virtual void visit ( const TDLConceptTop& ) { setConst ( false, true ); }
+	virtual void visit ( const TDLConceptBottom& ) { setConst ( true, false ); }
+	virtual void visit ( const TDLConceptName& expr ) { setEntity ( expr.getEntity(), topC ); }
+	virtual void visit ( const TDLConceptNot& expr ) { setNot(expr.getC()); }
+	virtual void visit ( const TDLConceptAnd& expr ) { setAnd ( expr.begin(), expr.end() ); }
+	virtual void visit ( const TDLConceptOr& expr ) { setOr ( expr.begin(), expr.end() ); }
+	virtual void visit ( const TDLConceptOneOf& expr ) { setConst ( expr.empty(), false ); }
+	virtual void visit ( const TDLConceptObjectSelf& expr ) { get(expr.getOR()); }
+	virtual void visit ( const TDLConceptObjectValue& expr ) { get(expr.getOR()); }
+	virtual void visit ( const TDLConceptObjectExists& expr ) { setMin ( 1, expr.getOR(), expr.getC() ); }
+	virtual void visit ( const TDLConceptObjectForall& expr )
+	{
+		ExprConditions R = get(expr.getOR()), C = get(expr.getC());
+		Expr = ExprConditions ( R.NotTop | C.NotBot, C.NotTop & R.NotBot );
+	}
+	virtual void visit ( const TDLConceptObjectMinCardinality& expr ) { setMin ( expr.getNumber(), expr.getOR(), expr.getC() ); }
+	virtual void visit ( const TDLConceptObjectMaxCardinality& expr ) { setMax ( expr.getNumber(), expr.getOR(), expr.getC() ); }
+	virtual void visit ( const TDLConceptObjectExactCardinality& expr ) { setExact ( expr.getNumber(), expr.getOR(), expr.getC() ); }
+	virtual void visit ( const TDLConceptDataValue& expr ) { get(expr.getDR()); }
+	virtual void visit ( const TDLConceptDataExists& expr ) { setMin ( 1, expr.getDR(), expr.getExpr() ); }
+	virtual void visit ( const TDLConceptDataForall& expr )
+	{
+		ExprConditions R = get(expr.getDR()), D = get(expr.getExpr());
+		// bot-eq iff R is top-eq and D is not: negation of D's condition is only possible for constants
+		SigCondition topD = D.NotTop.isTrue() ? SigCondition(false) : D.NotTop.isFalse() ? SigCondition(true) : SigCondition::invalid();
+		Expr = ExprConditions ( R.NotTop | topD, D.NotTop & R.NotBot );
+	}
+	virtual void visit ( const TDLConceptDataMinCardinality& expr ) { setMin ( expr.getNumber(), expr.getDR(), expr.getExpr() ); }
+	virtual void visit ( const TDLConceptDataMaxCardinality& expr ) { setMax ( expr.getNumber(), expr.getDR(), expr.getExpr() ); }
+	virtual void visit ( const TDLConceptDataExactCardinality& expr ) { setExact ( expr.getNumber(), expr.getDR(), expr.getExpr() ); }
+
+	// object role expressions
+	virtual void visit ( const TDLObjectRoleTop& ) { setConst ( false, true ); }
+	virtual void visit ( const TDLObjectRoleBottom& ) { setConst ( true, false ); }
+	virtual void visit ( const TDLObjectRoleName& expr ) { setEntity ( expr.getEntity(), topR ); }
+	virtual void visit ( const TDLObjectRoleInverse& expr ) { get(expr.getOR()); }
+	virtual void visit ( const TDLObjectRoleChain& expr ) { setAnd ( expr.begin(), expr.end() ); }
+	virtual void visit ( const TDLObjectRoleProjectionFrom& expr ) { setMin ( 1, expr.getOR(), expr.getC() ); }
+	virtual void visit ( const TDLObjectRoleProjectionInto& expr ) { setMin ( 1, expr.getOR(), expr.getC() ); }
+
+	// data role expressions
+	virtual void visit ( const TDLDataRoleTop& ) { setConst ( false, true ); }
+	virtual void visit ( const TDLDataRoleBottom& ) { setConst ( true, false ); }
+	virtual void visit ( const TDLDataRoleName& expr ) { setEntity ( expr.getEntity(), topR ); }
+
+	// data expressions
+	virtual void visit ( const TDLDataTop& ) { setConst ( false, true ); }
+	virtual void visit ( const TDLDataBottom& ) { setConst ( true, false ); }
+	virtual void visit ( const TDLDataTypeName& ) { setConst ( false, false ); }
+	virtual void visit ( const TDLDataTypeRestriction& ) { setConst ( false, false ); }
+	virtual void visit ( const TDLDataValue& ) { setConst ( false, false ); }
+	virtual void visit ( const TDLDataNot& expr ) { setNot(expr.getExpr()); }
+	virtual void visit ( const TDLDataAnd& expr ) { setAnd ( expr.begin(), expr.end() ); }
+	virtual void visit ( const TDLDataOr& expr ) { setOr ( expr.begin(), expr.end() ); }
+	virtual void visit ( const TDLDataOneOf& expr ) { setConst ( expr.empty(), false ); }
+
+public:		// axiom visitor interface
+	virtual void visit ( const TDLAxiomDeclaration& ) { NonLocal = SigCondition(false); }
+
+	virtual void visit ( const TDLAxiomEquivalentConcepts& axiom ) { processEquivalentAxiom(axiom); }
+	virtual void visit ( const TDLAxiomDisjointConcepts& axiom ) { processDisjointAxiom(axiom); }
+	virtual void visit ( const TDLAxiomDisjointUnion& axiom )
+	{
+		// local iff (1) A and all of Ci are bot-eq, or (2) A and one Ci are top-eq and the remaining Cj are bot-eq
+		ExprConditions A = get(axiom.getC());
+		std::vector<ExprConditions> args;
+		for ( TDLAxiomDisjointUnion::iterator p = axiom.begin(), p_end = axiom.end(); p != p_end; ++p )
+			args.push_back(get(*p));
+		SigCondition not1 = A.NotBot, not2(true);
+		for ( size_t i = 0; i < args.size(); ++i )
+		{
+			not1 |= args[i].NotBot;
+			SigCondition notI = args[i].NotTop;
+			for ( size_t j = 0; j < args.size(); ++j )
+				if ( j != i )
+					notI |= args[j].NotBot;
+			not2 &= notI;
+		}
+		NonLocal = not1 & ( A.NotTop | not2 );
+	}
+	virtual void visit ( const TDLAxiomEquivalentORoles& axiom ) { processEquivalentAxiom(axiom); }
+	virtual void visit ( const TDLAxiomEquivalentDRoles& axiom ) { processEquivalentAxiom(axiom); }
+	virtual void visit ( const TDLAxiomDisjointORoles& axiom ) { processDisjointAxiom(axiom); }
+	virtual void visit ( const TDLAxiomDisjointDRoles& axiom ) { processDisjointAxiom(axiom); }
+	virtual void visit ( const TDLAxiomSameIndividuals& ) { NonLocal = SigCondition(true); }
+	virtual void visit ( const TDLAxiomDifferentIndividuals& ) { NonLocal = SigCondition(true); }
+	virtual void visit ( const TDLAxiomFairnessConstraint& ) { NonLocal = SigCondition(false); }
+
+	virtual void visit ( const TDLAxiomRoleInverse& axiom )
+	{
+		ExprConditions R = get(axiom.getRole()), I = get(axiom.getInvRole());
+		NonLocal = ( R.NotBot | I.NotBot ) & ( R.NotTop | I.NotTop );
+	}
+	virtual void visit ( const TDLAxiomORoleSubsumption& axiom ) { NonLocal = notTop(axiom.getRole()) & notBot(axiom.getSubRole()); }
+	virtual void visit ( const TDLAxiomDRoleSubsumption& axiom ) { NonLocal = notTop(axiom.getRole()) & notBot(axiom.getSubRole()); }
+	virtual void visit ( const TDLAxiomORoleDomain& axiom ) { NonLocal = notTop(axiom.getDomain()) & notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomDRoleDomain& axiom ) { NonLocal = notTop(axiom.getDomain()) & notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomORoleRange& axiom ) { NonLocal = notTop(axiom.getRange()) & notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomDRoleRange& axiom ) { NonLocal = notTop(axiom.getRange()) & notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomRoleTransitive& axiom ) { ExprConditions R = get(axiom.getRole()); NonLocal = R.NotBot & R.NotTop; }
+	virtual void visit ( const TDLAxiomRoleReflexive& axiom ) { NonLocal = notTop(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomRoleIrreflexive& axiom ) { NonLocal = notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomRoleSymmetric& axiom ) { ExprConditions R = get(axiom.getRole()); NonLocal = R.NotBot & R.NotTop; }
+	virtual void visit ( const TDLAxiomRoleAsymmetric& ) { NonLocal = SigCondition(true); }
+	virtual void visit ( const TDLAxiomORoleFunctional& axiom ) { NonLocal = notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomDRoleFunctional& axiom ) { NonLocal = notBot(axiom.getRole()); }
+	virtual void visit ( const TDLAxiomRoleInverseFunctional& axiom ) { NonLocal = notBot(axiom.getRole()); }
+
+	virtual void visit ( const TDLAxiomConceptInclusion& axiom ) { NonLocal = notBot(axiom.getSubC()) & notTop(axiom.getSupC()); }
+	virtual void visit ( const TDLAxiomInstanceOf& axiom ) { NonLocal = notTop(axiom.getC()); }
+	virtual void visit ( const TDLAxiomRelatedTo& axiom ) { NonLocal = notTop(axiom.getRelation()); }
+	virtual void visit ( const TDLAxiomRelatedToNot& axiom ) { NonLocal = notBot(axiom.getRelation()); }
+	virtual void visit ( const TDLAxiomValueOf& axiom ) { NonLocal = notTop(axiom.getAttribute()); }
+	virtual void visit ( const TDLAxiomValueOfNot& axiom ) { NonLocal = notBot(axiom.getAttribute()); }
+}; // LocalityCompiler
+
+/**
+ * Compiled syntactic locality of the registered axioms. For every axiom and
+ * locality class the non-locality condition is kept as a list of clauses, each
+ * with a counter of its entities that are not yet in the module signature.
+ * Entities entering the signature decrement the counters; the axiom becomes
+ * non-local as soon as one of the counters drops to zero.
+ */
+class CompiledLocality
+{
+public:		// types
+		/// counters of a single extraction; different extractions could run concurrently using different states
+	class PassState
+	{
+	protected:	// members
+		friend class CompiledLocality;
+			/// number of entities of a clause that are not in the signature; indexed by the global clause number
+		std::vector<unsigned int> Counters;
+			/// pass in which the counters of a condition were set; indexed by the condition number
+		std::vector<unsigned int> Stamp;
+			/// current extraction pass
+		unsigned int Pass;
+			/// finished state to take the initial counters from (if any)
+		const PassState* Init;
+
+	public:		// interface
+			/// empty c'tor
+		PassState ( void ) : Pass(0), Init(nullptr) {}
+			/// start new extraction pass; the counters are taken from the finished state BASE if it touched them
+		void newPass ( const PassState* base = nullptr ) { ++Pass; Init = base; }
+	}; // PassState
+
+protected:	// types
+		/// compiled condition of a single axiom wrt a single locality class
+	struct Condition
+	{
+			/// entities of all the clauses one after another
+		std::vector<const TNamedEntity*> Entities;
+			/// end of every clause in Entities
+		std::vector<unsigned int> Ends;
+			/// global number of the first clause
+		unsigned int First;
+			/// true iff the condition is compiled
+		bool Compiled;
+
+			/// empty c'tor
+		Condition ( void ) : First(0), Compiled(false) {}
+	}; // Condition
+		/// compiled conditions of an axiom
+	struct Entry
+	{
+			/// axiom the conditions belong to
+		const TDLAxiom* Axiom;
+			/// conditions wrt top- (index 0) and bottom (index 1) locality
+		Condition Cond[2];
+
+			/// empty c'tor
+		Entry ( void ) : Axiom(nullptr) {}
+	}; // Entry
+
+protected:	// members
+		/// compiled axioms indexed by their ids
+	std::vector<Entry> Base;
+		/// number of clauses in all the conditions
+	unsigned int nClauses;
+		/// state for the extractions that don't provide their own
+	PassState State;
+
+protected:	// methods
+		/// @return compiled entry for the AXiom; NULL if there is none
+	const Entry* getEntry ( const TDLAxiom* ax ) const
+	{
+		unsigned int id = ax->getId();
+		if ( id < Base.size() && Base[id].Axiom == ax )
+			return &Base[id];
+		return nullptr;
+	}
+		/// init the condition COND by the compiled condition C
+	void init ( Condition& cond, const SigCondition& c );
+
+public:		// interface
+		/// empty c'tor
+	CompiledLocality ( void ) : nClauses(0) {}
+
+		/// compile both locality conditions for the axiom AX
+	void registerAx ( const TDLAxiom* ax );
+		/// forget compiled conditions of the axiom AX
+	void unregisterAx ( const TDLAxiom* ax )
+	{
+		if ( getEntry(ax) != nullptr )
+			Base[ax->getId()] = Entry();
+	}
+		/// clear all the compiled information
+	void clear ( void ) { Base.clear(); nClauses = 0; }
+
+		/// start new extraction pass with the internal state: all the counters are reset lazily
+	void newPass ( void ) { State.newPass(); }
+		/// @return true iff the locality of AX wrt top-locality value TOP is compiled
+	bool isCompiled ( const TDLAxiom* ax, bool top ) const
+	{
+		const Entry* entry = getEntry(ax);
+		return entry != nullptr && entry->Cond[!top].Compiled;
+	}
+		/// note that ENTITY was added to the signature; @return true iff AX becomes non-local wrt top-locality value TOP
+	bool addEntity ( const TDLAxiom* ax, bool top, const TNamedEntity* entity, PassState& state ) const;
+		/// the same as above using the internal state
+	bool addEntity ( const TDLAxiom* ax, bool top, const TNamedEntity* entity ) { return addEntity ( ax, top, entity, State ); }
+}; // CompiledLocality
+
+#endif
@@ -20,12 +20,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 |* Implementation of taxonomy building for the FaCT++  *|
 \*******************************************************/
 
+#include <algorithm>
 #include <queue>
 #include <iostream>
 #include <fstream>
 
 #include "Reasoner.h"
 #include "DLConceptTaxonomy.h"
+#include "SubsumptionBatch.h"
+#include "eFPPTimeout.h"
 #include "procTimer.h"
 #include "globaldef.h"
 #include "logging.h"
@@ -35,15 +38,26 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 \********************************************************/
 
 bool DLConceptTaxonomy :: testSub ( const TConcept* p, const TConcept* q )
+{
+	bool result;
+	if ( testSubCheap ( p, q, result ) )
+		return result;
+
+	return testSubTBox ( p, q );
+}
+
+bool DLConceptTaxonomy :: testSubCheap ( const TConcept* p, const TConcept* q, bool& result )
 {
 	fpp_assert ( p != nullptr );
 	fpp_assert ( q != nullptr );
 
+	result = false;
+
 //	std::cout << "Testing sub " << p->getName() << " [= " << q->getName() << std::endl;
 	if ( q->isSingleton()		// singleton on the RHS is useless iff...
 		 && q->isPrimitive()	// it is primitive
 		 && !q->isNominal() )	// nominals should be classified as usual concepts
-		return false;
+		return true;
 
 	if ( LLM.isWritable(llTaxTrying) )
 		LL << "\nTAX: trying '" << p->getName() << "' [= '" << q->getName() << "'... ";
@@ -54,7 +68,7 @@ bool DLConceptTaxonomy :: testSub ( const TConcept* p, const TConcept* q )
 			LL << "NOT holds (sorted result)";
 
 		++nSortedNegative;
-		return false;
+		return true;
 	}
 
 	if ( isNotInModule(q->getEntity()) )
@@ -63,7 +77,7 @@ bool DLConceptTaxonomy :: testSub ( const TConcept* p, const TConcept* q )
 			LL << "NOT holds (module result)";
 
 		++nModuleNegative;
-		return false;
+		return true;
 	}
 
 	switch ( tBox.testCachedNonSubsumption ( p, q ) )
@@ -73,23 +87,22 @@ bool DLConceptTaxonomy :: testSub ( const TConcept* p, const TConcept* q )
 			LL << "NOT holds (cached result)";
 
 		++nCachedNegative;
-		return false;
+		return true;
 
 	case csInvalid:	// cached result: unsatisfiable => subsumption holds
 		if ( LLM.isWritable(llTaxTrying) )
 			LL << "holds (cached result)";
 
 		++nCachedPositive;
+		result = true;
 		return true;
 
 	default:		// need extra tests
 		if ( LLM.isWritable(llTaxTrying) )
 			LL << "wasted cache test";
 
-		break;
+		return false;
 	}
-
-	return testSubTBox ( p, q );
 }
 
 bool
@@ -138,6 +151,10 @@ void DLConceptTaxonomy :: print ( std::ostream& o ) const
 		o << "Modular reasoning deals with " << nModuleNegative << " non-subsumptions\n";
 	o << "There were made " << nSearchCalls << " search calls\nThere were made " << nSubCalls
 	  << " Sub calls, of which " << nNonTrivialSubCalls << " non-trivial\n";
+	if ( nParallelTests )
+		o << "Among the subsumption tests " << nParallelTests << " were made in parallel\n";
+	if ( nShapeRealised )
+		o << "There were " << nShapeRealised << " individuals realised as the ones of the same shape\n";
 	o << "Current efficiency (wrt Brute-force) is " << nEntries*(nEntries-1)/n << "\n";
 
 	TaxonomyCreator::print(o);
@@ -147,12 +164,19 @@ void DLConceptTaxonomy :: print ( std::ostream& o ) const
 void
 DLConceptTaxonomy :: searchBaader ( TaxonomyVertex* cur )
 {
+	// search in a large taxonomy might take long even if all the tests are cached
+	tBox.checkDeadline();
+
 	// label 'visited'
 	pTax->setVisited(cur);
 
 	++nSearchCalls;
 	bool noPosSucc = true;
 
+	// siblings' tests are independent, so do them in parallel if possible
+	if ( tBox.useParallelSub() && !upDirection )
+		testChildrenConcurrently(cur);
+
 	// check if there are positive successors; use DFS on them.
 	for ( TaxonomyVertex::iterator p = cur->begin(upDirection), p_end = cur->end(upDirection); p != p_end; ++p )
 		if ( enhancedSubs(*p) )
@@ -172,6 +196,55 @@ DLConceptTaxonomy :: searchBaader ( TaxonomyVertex* cur )
 		pTax->getCurrent()->addNeighbour ( !upDirection, cur );
 }
 
+void
+DLConceptTaxonomy :: testChildrenConcurrently ( TaxonomyVertex* cur )
+{
+	typedef std::pair<TaxonomyVertex*, size_t> ScheduledTest;
+	std::vector<ScheduledTest> scheduled;
+	SubsumptionBatch& batch = tBox.getSubBatch();
+
+	for ( TaxonomyVertex::iterator p = cur->begin(/*upDirection=*/false), p_end = cur->end(/*upDirection=*/false); p != p_end; ++p )
+	{
+		TaxonomyVertex* v = *p;
+		if ( isValued(v) || ( useCandidates && candidates.find(v) == candidates.end() ) )
+			continue;
+
+		// the test is necessary iff all the parents of V subsume the current concept (cf. enhancedSubs1())
+		bool ready = true;
+		for ( TaxonomyVertex::iterator q = v->begin(/*upDirection=*/true), q_end = v->end(/*upDirection=*/true); ready && q != q_end; ++q )
+			ready = isValued(*q) && getValue(*q);
+		if ( !ready )
+			continue;
+
+		const TConcept* testC = static_cast<const TConcept*>(v->getPrimer());
+		bool result;
+		size_t index;
+		if ( testSubCheap ( curConcept(), testC, result ) )
+		{
+			++nNonTrivialSubCalls;
+			setValue ( v, result );
+		}
+		else if ( tBox.scheduleSub ( curConcept(), testC, index ) )
+			scheduled.push_back(ScheduledTest(v,index));
+	}
+
+	if ( batch.worthRunning() )
+	{
+		batch.run();
+		for ( std::vector<ScheduledTest>::iterator p = scheduled.begin(), p_end = scheduled.end(); p != p_end; ++p )
+		{
+			bool result;
+			// unfinished tests would be re-made by the usual search
+			if ( !batch.getResult ( p->second, result ) )
+				continue;
+			++nNonTrivialSubCalls;
+			++nParallelTests;
+			setValue ( p->first, recordSubResult(result) );
+		}
+	}
+	batch.clear();
+}
+
 bool
 DLConceptTaxonomy :: enhancedSubs1 ( TaxonomyVertex* cur )
 {
@@ -302,6 +375,87 @@ DLConceptTaxonomy :: classifySynonym ( void )
 	return false;
 }
 
+/// build the SHAPE of the individual IND; @return false if IND might be distinguished by nominals or rules
+bool
+DLConceptTaxonomy :: buildShape ( const TIndividual* ind, IndividualShape& shape )
+{
+	// nominals and rules could refer to the individual itself
+	if ( ind->isNominal() || ind->hasExtraRules() || !ind->isPrimitive() )
+		return false;
+
+	shape.body = ind->pBody;
+
+	shape.related.clear();
+	for ( const auto& related: ind->RelatedIndex )
+	{
+		// swapping individuals of the same shape would break the loops
+		if ( related->b == ind )
+			return false;
+		shape.related.push_back(std::make_pair(related->R,related->b));
+	}
+	std::sort ( shape.related.begin(), shape.related.end() );
+	shape.related.erase ( std::unique ( shape.related.begin(), shape.related.end() ), shape.related.end() );
+
+	if ( !differentIndexed )
+	{
+		for ( size_t i = 0; i < tBox.Different.size(); ++i )
+			for ( const auto& p: tBox.Different[i] )
+				DifferentIndex[p].push_back(i);
+		differentIndexed = true;
+	}
+	std::map<const TIndividual*, std::vector<size_t> >::const_iterator p = DifferentIndex.find(ind);
+	if ( p != DifferentIndex.end() )
+		shape.different = p->second;
+	else
+		shape.different.clear();
+
+	return true;
+}
+
+/// @return true iff curEntry is an individual that is classified as the realised individual of the same shape
+bool
+DLConceptTaxonomy :: classifyByShape ( void )
+{
+	if ( !tBox.useIndividualGroups || !curConcept()->isSingleton() || pTax->queryMode() )
+		return false;
+
+	// individuals of the same shape could be swapped in every model of the KB, so they have the same types
+	const TIndividual* curI = static_cast<const TIndividual*>(curConcept());
+	IndividualShape shape;
+	if ( !buildShape ( curI, shape ) )
+		return false;
+
+	std::pair<std::map<IndividualShape, const TIndividual*>::iterator, bool> ins =
+		ShapeSamples.insert(std::make_pair(shape,curI));
+	if ( ins.second )	// the first one of its shape: classify it as usual
+		return false;
+
+	const TIndividual* sample = ins.first->second;
+	// the sample's classification might be interrupted before
+	if ( sample == curI )
+		return false;
+	TaxonomyVertex* v = sample->getTaxVertex();
+	// the sample should occupy its own vertex, with no concepts below it
+	if ( v == nullptr || v->getPrimer() != sample )
+		return false;
+	for ( TaxonomyVertex::iterator p = v->begin(/*upDirection=*/false), p_end = v->end(/*upDirection=*/false); p != p_end; ++p )
+		if ( *p != pTax->getBottomVertex() )
+			return false;
+
+	if ( LLM.isWritable(llTaxTrying) )
+		LL << "\nTAX: realise '" << curI->getName() << "' as '" << sample->getName() << "'";
+
+	// the same neighbours as the sample has
+	for ( TaxonomyVertex::iterator p = v->begin(/*upDirection=*/true), p_end = v->end(/*upDirection=*/true); p != p_end; ++p )
+		pTax->getCurrent()->addNeighbour ( /*upDirection=*/true, *p );
+	for ( TaxonomyVertex::iterator p = v->begin(/*upDirection=*/false), p_end = v->end(/*upDirection=*/false); p != p_end; ++p )
+		pTax->getCurrent()->addNeighbour ( /*upDirection=*/false, *p );
+	pTax->finishCurrentNode();
+
+	++nShapeRealised;
+	return true;
+}
+
 void 		/// fill candidates
 DLConceptTaxonomy :: fillCandidates ( TaxonomyVertex* cur )
 {
@@ -324,6 +478,10 @@ DLConceptTaxonomy :: reclassify ( const std::set<const TNamedEntity*>& plus, con
 	MPlus = plus;
 	MMinus = minus;
 	pTax->deFinalise();
+	// the changed individuals might not look like their samples any more
+	ShapeSamples.clear();
+	DifferentIndex.clear();
+	differentIndexed = false;
 
 	// fill in an order to
 	std::queue<TaxonomyVertex*> queue;
@@ -427,7 +585,17 @@ DLConceptTaxonomy :: reclassify ( TaxonomyVertex* node, const TSignature* s )
 	// FIXME!! for now. later check the equivalence etc
 	setValue ( node, true );
 	// the landscape is prepared
-	searchBaader(pTax->getTopVertex());
+	try
+	{
+		searchBaader(pTax->getTopVertex());
+	}
+	catch ( const EFPPTimeout& )
+	{	// the kernel would reload the taxonomy, so just restore the creator's state
+		clearLabels();
+		sigStack.pop();
+		pTax->setCurrent(oldCur);
+		throw;
+	}
 	node->incorporate();
 	clearLabels();
 	sigStack.pop();
@@ -528,11 +696,16 @@ TBox :: classifyConcepts ( const ConceptVector& collection, bool curCompletelyDe
 		LL << "\n\n---Start classifying " << type << " concepts";
 
 	unsigned int n = 0;
+	ConceptVector::const_iterator prefetched = collection.begin();
 
 	for ( ConceptVector::const_iterator q = collection.begin(), q_end = collection.end(); q < q_end; ++q )
 		// check if concept is already classified
 		if ( !isCancelled() && !(*q)->isClassified () /*&& (*q)->isClassifiable(curCompletelyDefined)*/ )
 		{
+			checkDeadline();
+			// build caches for the next portion of concepts in parallel
+			if ( usePrefetch() && q >= prefetched )
+				prefetched = prefetchCaches ( q, q_end );
 			classifyEntry(*q);	// need to classify concept
 			if ( (*q)->isClassified() )
 				++n;
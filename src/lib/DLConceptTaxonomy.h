@@ -19,6 +19,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef DLCONCEPTTAXONOMY_H
 #define DLCONCEPTTAXONOMY_H
 
+#include <map>
+
 #include "TaxonomyCreator.h"
 #include "dlTBox.h"
 #include "tProgressMonitor.h"
@@ -62,6 +64,26 @@ protected:	// types
 			/// end of the Possible subsumers interval
 		virtual ss_iterator p_end ( void ) { return Possible.end(); }
 	}; // DerivedSubsumers
+		/// everything the realisation of an individual depends on; individuals of the same shape have the same types
+	struct IndividualShape
+	{
+			/// DAG entry of the description
+		BipolarPointer body;
+			/// sorted related individuals together with the roles (both directions)
+		std::vector<std::pair<const TRole*, const TIndividual*> > related;
+			/// sorted indices of the different-individuals groups containing the individual
+		std::vector<size_t> different;
+
+			/// lexicographic order
+		bool operator < ( const IndividualShape& s ) const
+		{
+			if ( body != s.body )
+				return body < s.body;
+			if ( related != s.related )
+				return related < s.related;
+			return different < s.different;
+		}
+	}; // IndividualShape
 
 protected:	// members
 		/// host tBox
@@ -85,6 +107,8 @@ protected:	// members
 	unsigned long nSearchCalls;
 	unsigned long nSubCalls;
 	unsigned long nNonTrivialSubCalls;
+		/// number of subsumption tests made in parallel
+	unsigned long nParallelTests;
 
 		/// number of positive cached subsumptions
 	unsigned long nCachedPositive;
@@ -94,6 +118,15 @@ protected:	// members
 	unsigned long nSortedNegative;
 		/// number of non-subsumptions because of module reasons
 	unsigned long nModuleNegative;
+		/// number of individuals realised by the individual of the same shape
+	unsigned long nShapeRealised;
+
+		/// the first individual of every shape met during the realisation
+	std::map<IndividualShape, const TIndividual*> ShapeSamples;
+		/// indices of the different-individuals groups for every individual in any of them
+	std::map<const TIndividual*, std::vector<size_t> > DifferentIndex;
+		/// true iff DifferentIndex is built
+	bool differentIndexed;
 
 		/// indicator of taxonomy creation progress
 	TProgressMonitor* pTaxProgress;
@@ -112,12 +145,11 @@ protected:	// methods
 	const TConcept* curConcept ( void ) const { return static_cast<const TConcept*>(curEntry); }
 		/// tests subsumption (via tBox) and gather statistics.  Use cache and other optimisations.
 	bool testSub ( const TConcept* p, const TConcept* q );
-		/// test subsumption via TBox explicitly
-	bool testSubTBox ( const TConcept* p, const TConcept* q )
+		/// tests subsumption without a TBox reasoning; @return true iff the test is done, the result is in RESULT then
+	bool testSubCheap ( const TConcept* p, const TConcept* q, bool& result );
+		/// update statistic wrt the result RES of the TBox subsumption test; @return RES
+	bool recordSubResult ( bool res )
 	{
-		bool res = tBox.isSubHolds ( p, q );
-
-		// update statistic
 		++nTries;
 
 		if ( res )
@@ -127,6 +159,10 @@ protected:	// methods
 
 		return res;
 	}
+		/// test subsumption via TBox explicitly
+	bool testSubTBox ( const TConcept* p, const TConcept* q ) { return recordSubResult ( tBox.isSubHolds ( p, q ) ); }
+		/// test subsumptions of the current concept by all the children of CUR that are ready for testing in parallel
+	void testChildrenConcurrently ( TaxonomyVertex* cur );
 
 	// interface from BAADER paper
 
@@ -237,6 +273,10 @@ protected:	// methods
 	}
 		/// @return true iff curEntry is classified as a synonym
 	virtual bool classifySynonym ( void );
+		/// build the SHAPE of the individual IND; @return false if IND might be distinguished by nominals or rules
+	bool buildShape ( const TIndividual* ind, IndividualShape& shape );
+		/// @return true iff curEntry is an individual that is classified as the realised individual of the same shape
+	bool classifyByShape ( void );
 
 		/// check if it is necessary to log taxonomy action
 	virtual bool needLogging ( void ) const { return true; }
@@ -252,10 +292,13 @@ public:		// interface
 		, nSearchCalls(0)
 		, nSubCalls(0)
 		, nNonTrivialSubCalls(0)
+		, nParallelTests(0)
 		, nCachedPositive(0)
 		, nCachedNegative(0)
 		, nSortedNegative(0)
 		, nModuleNegative(0)
+		, nShapeRealised(0)
+		, differentIndexed(false)
 		, pTaxProgress(nullptr)
 	{
 	}
@@ -296,6 +339,9 @@ inline bool DLConceptTaxonomy :: immediatelyClassified ( void )
 	if ( classifySynonym() )
 		return true;
 
+	if ( classifyByShape() )
+		return true;
+
 	if ( curConcept()->getClassTag() == cttTrueCompletelyDefined )
 		return false;	// true CD concepts can not be unsat
 
@@ -21,7 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //toms code start
 bool DataTypeReasoner :: addDataEntry ( BipolarPointer p, const DepSet& dep )
 {
-	switch ( DLHeap[p].Type() )
+	switch ( DLHeap.getTag(p) )
 	{
 	case dtDataType:		// get appropriate type
 	{
@@ -0,0 +1,277 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+#include "EventLog.h"
+#include "dlVertex.h"
+#include "modelCacheInterface.h"
+
+// the only element of ELM
+EventLogger ELM;
+
+//-------------------------------------------------------------
+// binary format support
+//-------------------------------------------------------------
+
+namespace {
+
+/// magic string at the beginning of a dump
+const char EventLogMagic[] = "FPPEVL";
+/// version of the dump format
+const char EventLogVersion = 1;
+
+/// write VALUE to O as SIZE bytes, the least significant first
+void writeUInt ( std::ostream& o, uint64_t value, unsigned int size )
+{
+	char buf[8];
+	for ( unsigned int i = 0; i < size; ++i, value >>= 8 )
+		buf[i] = static_cast<char>(value & 0xFF);
+	o.write ( buf, size );
+}
+
+/// read SIZE bytes written by writeUInt() from I to VALUE; @return false if I is over
+bool readUInt ( std::istream& i, uint64_t& value, unsigned int size )
+{
+	unsigned char buf[8];
+	if ( !i.read ( reinterpret_cast<char*>(buf), size ) )
+		return false;
+	value = 0;
+	for ( unsigned int j = size; j > 0; --j )
+		value = (value << 8) | buf[j-1];
+	return true;
+}
+
+/// @return name of the event KIND
+const char* getKindName ( unsigned int kind )
+{
+	switch ( kind )
+	{
+	case evSatStart:	return "sat-start";
+	case evSatFinish:	return "sat-finish";
+	case evRule:		return "rule";
+	case evClash:		return "clash";
+	case evBacktrack:	return "backtrack";
+	case evNodeCache:	return "node-cache";
+	case evSatCache:	return "sat-cache";
+	default:			return nullptr;
+	}
+}
+
+/// @return name of the model cache STATE
+const char* getCacheStateName ( unsigned int state )
+{
+	switch ( state )
+	{
+	case csInvalid:	return "invalid";
+	case csValid:	return "valid";
+	case csFailed:	return "failed";
+	case csUnknown:	return "unknown";
+	default:		return "bad-state";
+	}
+}
+
+/// print the event R to O
+void printEvent ( std::ostream& o, const EventRecord& r )
+{
+	o << r.Seq << ' ' << getKindName(r.Kind);
+	// concepts are bipolar pointers
+	int concept = static_cast<int32_t>(r.B);
+	switch ( r.Kind )
+	{
+	case evSatStart:
+		o << " p=" << static_cast<int32_t>(r.A) << " q=" << concept;
+		break;
+	case evSatFinish:
+		o << ( r.A ? " sat" : " unsat" ) << " time=" << r.B << "us";
+		break;
+	case evRule:
+		o << " node=" << r.A << " concept=" << concept << " tag=" << DLVertex(static_cast<DagTag>(r.Extra)).getTagName();
+		break;
+	case evClash:
+		o << " node=" << r.A << " concept=" << concept << " level=" << r.Extra;
+		break;
+	case evBacktrack:
+		o << " to=" << r.A << " from=" << r.B;
+		break;
+	case evNodeCache:
+		o << " node=" << r.A << " state=" << getCacheStateName(r.Extra);
+		break;
+	case evSatCache:
+		o << " concept=" << static_cast<int32_t>(r.A) << ( r.Extra ? " hit" : " miss" );
+		break;
+	default:
+		break;
+	}
+	o << "\n";
+}
+
+} // namespace
+
+//-------------------------------------------------------------
+// EventLog implementation
+//-------------------------------------------------------------
+
+void
+EventLog :: dump ( std::ostream& o ) const
+{
+	uint64_t size = Ring.size();
+	uint64_t n = Next < size ? Next : size;
+	writeUInt ( o, Thread, 4 );
+	writeUInt ( o, Next, 8 );
+	writeUInt ( o, n, 8 );
+	// the oldest kept event first
+	for ( uint64_t i = Next-n; i < Next; ++i )
+	{
+		const EventRecord& r = Ring[i & Mask];
+		writeUInt ( o, r.Seq, 4 );
+		writeUInt ( o, r.Kind, 2 );
+		writeUInt ( o, r.Extra, 2 );
+		writeUInt ( o, r.A, 4 );
+		writeUInt ( o, r.B, 4 );
+	}
+}
+
+//-------------------------------------------------------------
+// EventLogger implementation
+//-------------------------------------------------------------
+
+/// holder of the buffer of a thread
+struct LocalEventLog
+{
+		/// the buffer; created by the 1st event of the thread
+	EventLog* Log;
+
+		/// empty c'tor
+	LocalEventLog ( void ) : Log(nullptr) {}
+		/// d'tor: return the buffer to the logger
+	~LocalEventLog ( void )
+	{
+		if ( Log != nullptr )
+			ELM.release(Log);
+	}
+}; // LocalEventLog
+
+namespace {
+	/// buffer of the current thread
+	thread_local LocalEventLog Local;
+}
+
+EventLogger :: ~EventLogger ( void )
+{
+	for ( std::vector<EventLog*>::iterator p = Logs.begin(), p_end = Logs.end(); p != p_end; ++p )
+		delete *p;
+}
+
+EventLog*
+EventLogger :: acquire ( void )
+{
+	std::lock_guard<std::mutex> guard(Lock);
+	uint32_t thread = ++nThreads;
+	if ( !FreeLogs.empty() )
+	{
+		EventLog* log = FreeLogs.back();
+		FreeLogs.pop_back();
+		log->reset(thread);
+		return log;
+	}
+	Logs.push_back ( new EventLog ( LogSize, thread ) );
+	return Logs.back();
+}
+
+void
+EventLogger :: release ( EventLog* log )
+{
+	std::lock_guard<std::mutex> guard(Lock);
+	FreeLogs.push_back(log);
+}
+
+EventLog&
+EventLogger :: local ( void )
+{
+	if ( unlikely(Local.Log == nullptr) )
+		Local.Log = acquire();
+	return *Local.Log;
+}
+
+void
+EventLogger :: enable ( size_t size )
+{
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+		LogSize = size > 0 ? size : 1;
+	}
+	enabled.store(true,std::memory_order_relaxed);
+}
+
+void
+EventLogger :: dump ( std::ostream& o ) const
+{
+	std::lock_guard<std::mutex> guard(Lock);
+	o.write ( EventLogMagic, sizeof(EventLogMagic)-1 );
+	o.put(EventLogVersion);
+	writeUInt ( o, Logs.size(), 4 );
+	for ( std::vector<EventLog*>::const_iterator p = Logs.begin(), p_end = Logs.end(); p != p_end; ++p )
+		(*p)->dump(o);
+	o.flush();
+}
+
+bool
+EventLogger :: decode ( std::istream& i, std::ostream& o )
+{
+	char magic[sizeof(EventLogMagic)];
+	if ( !i.read ( magic, sizeof(EventLogMagic) ) || strncmp ( magic, EventLogMagic, sizeof(EventLogMagic)-1 ) != 0 )
+		return false;
+	if ( magic[sizeof(EventLogMagic)-1] != EventLogVersion )
+		return false;
+
+	uint64_t nLogs, thread, next, n, value;
+	if ( !readUInt ( i, nLogs, 4 ) )
+		return false;
+	for ( ; nLogs > 0; --nLogs )
+	{
+		if ( !readUInt ( i, thread, 4 ) || !readUInt ( i, next, 8 ) || !readUInt ( i, n, 8 ) || n > next )
+			return false;
+		o << "thread " << thread << ": " << next << " events, " << next-n << " lost\n";
+		for ( ; n > 0; --n )
+		{
+			EventRecord r;
+			if ( !readUInt ( i, value, 4 ) )
+				return false;
+			r.Seq = static_cast<uint32_t>(value);
+			if ( !readUInt ( i, value, 2 ) )
+				return false;
+			r.Kind = static_cast<uint16_t>(value);
+			if ( !readUInt ( i, value, 2 ) )
+				return false;
+			r.Extra = static_cast<uint16_t>(value);
+			if ( !readUInt ( i, value, 4 ) )
+				return false;
+			r.A = static_cast<uint32_t>(value);
+			if ( !readUInt ( i, value, 4 ) )
+				return false;
+			r.B = static_cast<uint32_t>(value);
+			if ( getKindName(r.Kind) == nullptr )
+				return false;
+			printEvent ( o, r );
+		}
+	}
+	return true;
+}
@@ -0,0 +1,167 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <vector>
+
+#include "globaldef.h"
+
+/// kinds of the reasoning events
+enum EventKind
+{
+	evNone = 0,
+	evSatStart,		// A: 1st concept, B: 2nd concept
+	evSatFinish,	// A: result, B: time in microseconds
+	evRule,			// A: node, B: concept, Extra: DAG tag
+	evClash,		// A: node, B: concept, Extra: branching level of the clash
+	evBacktrack,	// A: restored branching level, B: branching level before the restore
+	evNodeCache,	// A: node, Extra: model cache state
+	evSatCache,		// A: concept, Extra: 1 for a hit, 0 for a miss
+	evLastKind,
+};
+
+/// one event; it has the same layout in memory and in the dump
+struct EventRecord
+{
+		/// number of the event in the thread
+	uint32_t Seq;
+		/// kind of the event
+	uint16_t Kind;
+		/// small kind-specific argument
+	uint16_t Extra;
+		/// 1st kind-specific argument
+	uint32_t A;
+		/// 2nd kind-specific argument
+	uint32_t B;
+}; // EventRecord
+
+/// ring buffer of the events of one thread
+class EventLog
+{
+protected:	// members
+		/// the events
+	std::vector<EventRecord> Ring;
+		/// index mask; the size of the ring is a power of 2
+	uint32_t Mask;
+		/// number of events added since the buffer was (re)used
+	uint64_t Next;
+		/// number of the thread that uses the buffer
+	uint32_t Thread;
+
+public:		// interface
+		/// init c'tor: keep at least SIZE last events
+	EventLog ( size_t size, uint32_t thread ) : Next(0), Thread(thread)
+	{
+		size_t n = 1;
+		while ( n < size )
+			n <<= 1;
+		Ring.resize(n);
+		Mask = static_cast<uint32_t>(n-1);
+	}
+
+		/// start using the buffer by the THREAD
+	void reset ( uint32_t thread ) { Next = 0; Thread = thread; }
+		/// add the event
+	void add ( EventKind kind, uint16_t extra, uint32_t a, uint32_t b )
+	{
+		EventRecord& r = Ring[Next & Mask];
+		r.Seq = static_cast<uint32_t>(Next);
+		r.Kind = static_cast<uint16_t>(kind);
+		r.Extra = extra;
+		r.A = a;
+		r.B = b;
+		++Next;
+	}
+
+		/// write the buffer to O
+	void dump ( std::ostream& o ) const;
+}; // EventLog
+
+/**
+ * Manager of the per-thread event logs. Every thread writes to its own ring
+ * buffer without locking, so the logging could be left on; the buffers are
+ * dumped in a binary form on request and decoded offline. The buffer of a
+ * finished thread is kept (and dumped) until a new thread takes it.
+ */
+class EventLogger
+{
+protected:	// members
+		/// all the buffers
+	std::vector<EventLog*> Logs;
+		/// buffers of the finished threads
+	std::vector<EventLog*> FreeLogs;
+		/// lock for the lists of buffers
+	mutable std::mutex Lock;
+		/// number of events kept per thread
+	size_t LogSize;
+		/// number of threads that used the logger
+	uint32_t nThreads;
+		/// true iff the events are recorded
+	std::atomic<bool> enabled;
+
+protected:	// methods
+		/// get a buffer for a new thread
+	EventLog* acquire ( void );
+		/// return the buffer LOG of a finished thread
+	void release ( EventLog* log );
+		/// @return the buffer of the current thread
+	EventLog& local ( void );
+
+		/// holder of the buffer of a thread; returns it on the thread exit
+	friend struct LocalEventLog;
+
+public:		// interface
+		/// c'tor: logging is off
+	EventLogger ( void ) : LogSize(0), nThreads(0), enabled(false) {}
+		/// no copy c'tor
+	EventLogger ( const EventLogger& ) = delete;
+		/// no assignment
+	EventLogger& operator = ( const EventLogger& ) = delete;
+		/// d'tor
+	~EventLogger ( void );
+
+		/// start recording the last SIZE events of every thread; the threads that already log keep their buffers
+	void enable ( size_t size = 65536 );
+		/// stop recording the events
+	void disable ( void ) { enabled.store(false,std::memory_order_relaxed); }
+		/// @return true iff the events are recorded
+	bool isEnabled ( void ) const { return enabled.load(std::memory_order_relaxed); }
+
+		/// record the event of the KIND with the arguments EXTRA, A and B
+	void add ( EventKind kind, uint16_t extra, uint32_t a, uint32_t b ) { local().add ( kind, extra, a, b ); }
+
+		/// dump all the buffers to O in a binary form; the results are exact only if there is no reasoning at the moment
+	void dump ( std::ostream& o ) const;
+		/// decode the dump from I to a text in O; @return false iff the dump is malformed
+	static bool decode ( std::istream& i, std::ostream& o );
+}; // EventLogger
+
+/// the only event logger
+extern EventLogger ELM;
+
+/// record an event if the logging is on
+#define LOG_EVENT(kind,extra,a,b)	\
+	do { if ( unlikely(ELM.isEnabled()) ) ELM.add ( (kind), (uint16_t)(extra), (uint32_t)(a), (uint32_t)(b) ); } while (0)
+
+#endif
@@ -104,15 +104,15 @@ ReasoningKernel :: doIncremental ( void )
 	// re-set the modularizer to use updated ontology
 	delete ModSyn;
 	ModSyn = nullptr;
+	// the taxonomy will be changed, so the cached query positions are no longer valid
+	clearQueryCache();
 
 	std::set<const TNamedEntity*> MPlus, MMinus;
 	std::set<const TNamedEntry*> excluded;
 
 	// detect new- and old- signature elements
 	TSignature NewSig = Ontology.getSignature();
-	TSignature::BaseType RemovedEntities, AddedEntities;
-	std::set_difference(OntoSig.begin(), OntoSig.end(), NewSig.begin(), NewSig.end(), inserter(RemovedEntities, RemovedEntities.begin()));
-	std::set_difference(NewSig.begin(), NewSig.end(), OntoSig.begin(), OntoSig.end(), inserter(AddedEntities, AddedEntities.begin()));
+	TSignature::BaseType RemovedEntities = difference ( OntoSig, NewSig ), AddedEntities = difference ( NewSig, OntoSig );
 
 	Taxonomy* tax = getCTaxonomy();
 //	std::cout << "Original Taxonomy:";
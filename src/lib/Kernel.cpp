@@ -19,9 +19,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Kernel.h"
 #include "tOntologyLoader.h"
 #include "tOntologyPrinterLISP.h"
+#include "tAxiomStream.h"
 #include "AtomicDecomposer.h"
 #include "OntologyBasedModularizer.h"
 #include "eFPPSaveLoad.h"
+#include "eFPPTimeout.h"
 #include "SaveLoadManager.h"
 
 const char* ReasoningKernel :: Version = "1.6.4";
@@ -46,17 +48,26 @@ ReasoningKernel :: ReasoningKernel ( void )
 	, ModSem(nullptr)
 	, JNICache(nullptr)
 	, pSLManager(nullptr)
+	, pStreamLoader(nullptr)
+	, nStreamedAxioms(0)
 	, pMonitor(nullptr)
 	, OpTimeout(0)
+	, QueryBudget(0)
 	, verboseOutput(false)
 	, useUndefinedNames(true)
-	, cachedQuery(nullptr)
+	, QueryCache(16)
 	, cachedQueryTree(nullptr)
+	, cachedTreeConcept(nullptr)
+	, cachedTreeEpoch(0)
 	, reasoningFailed(false)
 	, NeedTracing(false)
 	, ignoreExprCache(false)
+	, QuerySig(nullptr)
+	, QuerySigVersion(0)
 	, useIncrementalReasoning(false)
 	, dumpOntology(false)
+	, useStreamingLoad(false)
+	, streamedInconsistent(false)
 {
 	// Intro
 	if ( KernelFirstRun )
@@ -88,10 +99,15 @@ ReasoningKernel :: ~ReasoningKernel ( void )
 void
 ReasoningKernel :: clearTBox ( void )
 {
+	delete pStreamLoader;
+	pStreamLoader = nullptr;
+	// cached queries refer to the TBox entries
+	clearQueryCache();
 	delete pTBox;
 	pTBox = nullptr;
 	delete pET;
 	pET = nullptr;
+	QuerySig = nullptr;
 	delete KE;
 	KE = nullptr;
 	delete AD;
@@ -112,6 +128,9 @@ ReasoningKernel :: needForceReload ( void ) const
 	// if no TBox known -- reload
 	if ( pTBox == nullptr )
 		return true;
+	// TBox with streamed assertions is not loaded yet
+	if ( nStreamedAxioms > 0 && pTBox->getStatus() == kbLoading )
+		return true;
 	// if ontology wasn't change -- no need to reload
 	if ( !Ontology.isChanged() )
 		return false;
@@ -125,9 +144,19 @@ ReasoningKernel :: needForceReload ( void ) const
 void
 ReasoningKernel :: forceReload ( void )
 {
-	// reset TBox
-	clearTBox();
-	newKB();
+	// reset TBox unless it keeps the streamed assertions
+	if ( nStreamedAxioms == 0 )
+	{
+		clearTBox();
+		newKB();
+	}
+	else if ( isTBoxPrepared() )	// safety check: addAxiom() rejects such changes
+		throw EFaCTPlusPlus("FaCT++ Kernel: Can't reload ontology with streamed assertions");
+	else	// the stream is over
+	{
+		delete pStreamLoader;
+		pStreamLoader = nullptr;
+	}
 
 	// Protege (as the only user of non-trivial monitors with reload) does not accept multiple usage of a monitor
 	// so switch it off after the 1st usage
@@ -149,6 +178,68 @@ ReasoningKernel :: forceReload ( void )
 
 	// after loading ontology became processed completely
 	Ontology.setProcessed();
+
+	// report inconsistency found while streaming
+	if ( streamedInconsistent )
+		throw EFPPInconsistentKB();
+}
+
+/// add AXIOM to the ontology; @return AXIOM
+TDLAxiom*
+ReasoningKernel :: addAxiom ( TDLAxiom* axiom )
+{
+	// reject the change now rather than fail in the next query
+	if ( unlikely(isStreamedKBFixed()) )
+	{
+		delete axiom;
+		throw EFaCTPlusPlus("FaCT++ Kernel: Can't change ontology with streamed assertions after the first query");
+	}
+	return Ontology.add(axiom);
+}
+
+/// retract an axiom
+void
+ReasoningKernel :: retract ( TDLAxiom* axiom )
+{
+	if ( axiom == nullptr )
+		throw EFaCTPlusPlus("FaCT++ Kernel: Can't retract streamed assertion");
+	if ( unlikely(isStreamedKBFixed()) )
+		throw EFaCTPlusPlus("FaCT++ Kernel: Can't change ontology with streamed assertions after the first query");
+	Ontology.retract(axiom);
+}
+
+/// add an ABox assertion AXIOM to the ontology, or load it directly to the TBox in the streaming mode
+TDLAxiom*
+ReasoningKernel :: addAssertion ( TDLAxiom* axiom )
+{
+	// streaming is only possible until the TBox is preprocessed
+	if ( !useStreamingLoad || isTBoxPrepared() )
+		return addAxiom(axiom);
+
+	newKB();
+	if ( pStreamLoader == nullptr )
+		pStreamLoader = new TOntologyLoader(*pTBox);
+
+	try
+	{
+		pStreamLoader->loadAxiom(*axiom);
+	}
+	catch ( const EFPPInconsistentKB& )
+	{	// will be reported during reasoning, as for a usual load
+		streamedInconsistent = true;
+	}
+	catch(...)
+	{
+		delete axiom;
+		getExpressionManager()->releaseTransient();
+		throw;
+	}
+
+	// the assertion is in the TBox now, so release it together with its expressions
+	delete axiom;
+	getExpressionManager()->releaseTransient();
+	++nStreamedAxioms;
+	return nullptr;
 }
 
 //-------------------------------------------------
@@ -206,20 +297,43 @@ ReasoningKernel :: processKB ( KBStatus status )
 	if ( curStatus == kbEmpty || curStatus == kbLoading )
 	{	// load and preprocess KB -- here might be failures
 		reasoningFailed = true;
+		bool incremental = false;
 
-		// load the axioms from the ontology to the TBox
-		if ( needForceReload() )
-			forceReload();
-		else	// just do incremental classification and exit
+		try
 		{
-			doIncremental();
+			// load the axioms from the ontology to the TBox,
+			// unless the query that ran out of time did it and left only the consistency check
+			if ( pTBox == nullptr || !pTBox->isPrepared() || Ontology.isChanged() )
+			{
+				if ( needForceReload() )
+					forceReload();
+				else	// just do incremental classification and exit
+				{
+					incremental = true;
+					doIncremental();
+					reasoningFailed = false;
+					return;
+				}
+			}
+
+			// do the preprocessing and consistency check
+			pTBox->isConsistent();
+		}
+		catch ( const EFPPTimeout& )
+		{
+			// running out of time doesn't break the KB, so the next query could try again
+			if ( incremental || pTBox == nullptr || !pTBox->isPrepared() )
+			{	// the half-done TBox can't be trusted: reload it from the ontology
+				// the streamed assertions are not there, so such a KB is lost: reasoningFailed stays set,
+				// and the later queries fail until the kernel is rebuilt by clearKB()
+				if ( nStreamedAxioms > 0 )
+					throw;
+				clearTBox();
+			}
 			reasoningFailed = false;
-			return;
+			throw;
 		}
 
-		// do the preprocessing and consistency check
-		pTBox->isConsistent();
-
 		// if there were no exception thrown -- clear the failure status
 		reasoningFailed = false;
 
@@ -245,7 +359,7 @@ void
 ReasoningKernel :: classifyQuery ( void )
 {
 	// make sure KB is classified
-	classifyKB();
+	ensureKBStatus(kbClassified);
 
 	// ... and the cache entry is properly cleared
 	fpp_assert ( cachedVertex == nullptr );
@@ -253,7 +367,7 @@ ReasoningKernel :: classifyQuery ( void )
 	// classify general query expression
 	bool complexQuery = getTBox()->isComplexQuery(cachedConcept);
 	if ( complexQuery )
-		getTBox()->classifyQueryConcept();
+		getTBox()->classifyQueryConcept(cachedConcept);
 
 	// now cached concept is classified
 	cachedVertex = cachedConcept->getTaxVertex();
@@ -263,9 +377,15 @@ ReasoningKernel :: classifyQuery ( void )
 		fpp_assert (!complexQuery);
 		cachedVertex = getCTaxonomy()->getFreshVertex(cachedConcept);
 	}
+}
 
-	// setup proper cache level
-	cacheLevel = csClassified;
+void
+ReasoningKernel :: clearQueryDAG ( void )
+{
+	unsigned int epoch = getTBox()->getQueryEpoch();
+	getTBox()->clearQueryConcept();
+	// the taxonomy is the same, so the positions of the cached queries are still valid
+	QueryCache.moveVertices ( epoch, getTBox()->getQueryEpoch() );
 }
 
 void
@@ -277,22 +397,24 @@ ReasoningKernel :: setUpSatCache ( DLTree* query )
 
 	// check if the query is already cached
 	if ( checkQueryCache(query) )
-	{	// the level should be the same
-		fpp_assert ( cacheLevel == csSat );
-		// nothing to do
+	{	// nothing to do
+		cachedConcept = cachedTreeConcept;
 		deleteTree(query);
 		return;
 	}
 
 	// clear currently cached query
-	clearQueryCache();
+	deleteTree(cachedQueryTree);
+	cachedQueryTree = nullptr;
+	cachedTreeConcept = nullptr;
 
 	// setup concept to be queried
 	setQueryConcept(query);
 
 	// everything is fine -- set up cache now
-	setQueryCache(query);
-	cacheLevel = csSat;
+	cachedQueryTree = query;
+	cachedTreeConcept = cachedConcept;
+	cachedTreeEpoch = getTBox()->getQueryEpoch();
 }
 
 void
@@ -302,56 +424,60 @@ ReasoningKernel :: setUpCache ( TConceptExpr* query, cacheStatus level )
 	// we should catch it before
 	fpp_assert ( !Ontology.isChanged() );
 
-	// check if the query is already cached
-	if ( checkQueryCache(query) )
+	// classification might clear the query part of the DAG, so do it before looking at the cache
+	if ( level == csClassified )
+		ensureKBStatus(kbClassified);
+
+	// the expressions are translated wrt the signature, so the cached queries are only valid until it changes
+	if ( unlikely(QuerySig != nullptr) && QuerySig->getVersion() != QuerySigVersion )
 	{
-		fpp_assert ( cacheLevel != csEmpty );
-		// query cached with the same or lower level -- nothing to do
-		if ( level <= cacheLevel )
-			return;
-		// the only other option is: cache level is SAT but CLASSIFIED is requested
-		fpp_assert ( level == csClassified );
-		fpp_assert ( cacheLevel == csSat );
-		// classify query and return
-		classifyQuery();
-		return;
+		clearQueryCache();
+		QuerySigVersion = QuerySig->getVersion();
 	}
 
-	// clear currently cached query
-	clearQueryCache();
+	TQueryCache::Entry& entry = QueryCache.get(query);
+	// the same expression might mean something else now
+	if ( ignoreExprCache )
+		entry.clear();
+
+	unsigned int epoch = getTBox()->getQueryEpoch();
+	QueryCache.count ( entry.hasConcept(epoch) && ( level == csSat || entry.hasVertex(epoch) ) );
+	cachedVertex = nullptr;
 
 	// setup concept to be queried
-	setQueryConcept(TreeDeleter(e(query)));
+	if ( entry.hasConcept(epoch) )
+		cachedConcept = entry.Concept;
+	else
+	{
+		setQueryConcept(TreeDeleter(e(query)));
+		// the DAG might be cleared while setting the concept up
+		epoch = getTBox()->getQueryEpoch();
+		entry.setConcept ( cachedConcept, epoch );
+	}
 
-	// everything is fine -- set up cache now
-	setQueryCache(query);
-	cacheLevel = csSat;
+	if ( level != csClassified )
+		return;
 
-	if ( level == csClassified )
-		classifyQuery();
+	if ( entry.hasVertex(epoch) )
+	{
+		cachedVertex = entry.Vertex;
+		return;
+	}
+
+	classifyQuery();
+
+	// keep the position of the query; the current vertex of the taxonomy will be reused, so take it over
+	Taxonomy* tax = getCTaxonomy();
+	if ( cachedVertex == tax->getCurrent() )
+		entry.setVertex ( tax->releaseCurrent(), epoch, /*own=*/true );
+	else if ( !tax->isFreshVertex(cachedVertex) )
+		entry.setVertex ( cachedVertex, epoch, /*own=*/false );
 }
 
 //-------------------------------------------------
 // concept subsumption query implementation
 //-------------------------------------------------
 
-/// class for exploring concept taxonomy to find super classes
-class SupConceptActor: public WalkerInterface
-{
-protected:
-	const ClassifiableEntry* pe;
-	void entry ( const ClassifiableEntry* q ) { if ( pe == q ) throw std::exception(); }
-public:
-	SupConceptActor ( ClassifiableEntry* q ) :pe(q) {}
-	virtual bool apply ( const TaxonomyVertex& v )
-	{
-		entry(v.getPrimer());
-		for ( const auto& synonym: v.synonyms() )
-			entry(synonym);
-		return true;
-	}
-}; // SupConceptActor
-
 /// @return true iff C [= D holds
 bool
 ReasoningKernel :: checkSub ( TConcept* C, TConcept* D )
@@ -374,11 +500,11 @@ ReasoningKernel :: checkSub ( TConcept* C, TConcept* D )
 		return true;
 	if ( getStatus() < kbClassified )	// unclassified => do via SAT test
 		return getTBox()->isSubHolds ( C, D );
-	// classified => do the taxonomy traversal
-	SupConceptActor actor(D);
-	Taxonomy* tax = getCTaxonomy();
-	try { tax->getRelativesInfo</*needCurrent=*/true, /*onlyDirect=*/false, /*upDirection=*/true> ( C->getTaxVertex(), actor ); return false; }
-	catch (...) { tax->clearVisited(); return true; }
+	// fresh concepts stay in the DAG after the queries, but they are not in the taxonomy
+	if ( unlikely(C->getTaxVertex() == nullptr) || unlikely(D->getTaxVertex() == nullptr) )
+		return getTBox()->isSubHolds ( C, D );
+	// classified => use the taxonomy
+	return getCTaxonomy()->isSubsumedBy ( C->getTaxVertex(), D->getTaxVertex() );
 }
 
 //-------------------------------------------------
@@ -619,6 +745,33 @@ ReasoningKernel :: getModule ( ModuleMethod moduleMethod, ModuleType moduleType
 	return getModExtractor(moduleMethod)->getModule ( Sig, moduleType );
 }
 
+/// add all the axioms from the binary axiom stream I to the ontology; @return number of added axioms
+size_t
+ReasoningKernel :: loadAxiomStream ( std::istream& i )
+{
+	// the reader adds the axioms to the ontology directly, so check the streaming restriction here
+	if ( unlikely(isStreamedKBFixed()) )
+		throw EFaCTPlusPlus("FaCT++ Kernel: Can't change ontology with streamed assertions after the first query");
+	TAxiomStreamReader reader ( i, Ontology );
+	return reader.read();
+}
+
+/// write all the axioms of the ontology to O as a binary axiom stream
+void
+ReasoningKernel :: saveAxiomStream ( std::ostream& o ) const
+{
+	TAxiomStreamWriter writer ( o, *Ontology.getExpressionManager() );
+	writer.write(Ontology);
+}
+
+/// get modules of an ontology wrt given method and type for all the SIGNATURES; use up to NTHREADS threads
+void
+ReasoningKernel :: getModules ( ModuleMethod moduleMethod, ModuleType moduleType, const std::vector<TSignature>& signatures,
+								std::vector<AxiomVec>& modules, unsigned int nThreads )
+{
+	getModExtractor(moduleMethod)->getModules ( signatures, moduleType, modules, nThreads );
+}
+
 /// get a set of axioms that corresponds to the atom with the id INDEX
 const AxiomVec&
 ReasoningKernel :: getNonLocal ( ModuleMethod moduleMethod, ModuleType moduleType )
@@ -742,7 +895,7 @@ bool ReasoningKernel :: initOptions ( void )
 		"orSortSub",
 		"Option 'orSortSub' define the sorting order of OR vertices in the DAG used in subsumption tests. "
 		"Option has form of string 'Mop', where 'M' is a sort field (could be 'D' for depth, 'S' for size, 'F' "
-		"for frequency, and '0' for no sorting), 'o' is a order field (could be 'a' for ascending and 'd' "
+		"for frequency, 'A' for the activity of the disjuncts in the recent clashes with ties broken by size, and '0' for no sorting), 'o' is a order field (could be 'a' for ascending and 'd' "
 		"for descending mode), and 'p' is a preference field (could be 'p' for preferencing non-generating "
 		"rules and 'n' for not doing so).",
 		ifOption::iotText,
@@ -796,6 +949,28 @@ bool ReasoningKernel :: initOptions ( void )
 		) )
 		return true;
 
+	// register "useNogoods" option -- 19/10/26
+	if ( KernelOptions.RegisterOption (
+		"useNogoods",
+		"Option 'useNogoods' switch learning of nogoods on and off. A nogood is a set of disjuncts chosen "
+		"in the root node that leads to a clash; the choices that repeat it are rejected in the later "
+		"branches and tests. Works only together with backjumping and without nominals.",
+		ifOption::iotBool,
+		"false"
+		) )
+		return true;
+
+	// register "useLabelCache" option -- 19/10/26
+	if ( KernelOptions.RegisterOption (
+		"useLabelCache",
+		"Option 'useLabelCache' switch caching of the node labels on and off. A label that appears in "
+		"several tree nodes is tested separately once; the result is used for all the nodes with this label "
+		"in the later tests. Works only without nominals.",
+		ifOption::iotBool,
+		"false"
+		) )
+		return true;
+
 	// register "testTimeout" option -- 21/08/09
 	if ( KernelOptions.RegisterOption (
 		"testTimeout",
@@ -805,6 +980,49 @@ bool ReasoningKernel :: initOptions ( void )
 		) )
 		return true;
 
+	// register "cacheThreads" option -- 18/10/26
+	if ( KernelOptions.RegisterOption (
+		"cacheThreads",
+		"Option 'cacheThreads' sets the number of threads used to build model caches for the concepts that "
+		"are going to be tested during classification. Values 0 and 1 mean no parallel cache building.",
+		ifOption::iotInt,
+		"0"
+		) )
+		return true;
+
+	// register "subsumptionThreads" option -- 19/10/26
+	if ( KernelOptions.RegisterOption (
+		"subsumptionThreads",
+		"Option 'subsumptionThreads' sets the number of threads used to test in parallel the subsumptions "
+		"between the classified concept and the siblings in the taxonomy. Values 0 and 1 mean no parallel tests.",
+		ifOption::iotInt,
+		"0"
+		) )
+		return true;
+
+	// register "useNominalSnapshot" option -- 18/10/26
+	if ( KernelOptions.RegisterOption (
+		"useNominalSnapshot",
+		"Option 'useNominalSnapshot' allows to start every test in the KB with nominals from the complete model "
+		"of the nominal cloud instead of re-building the non-deterministic part of it. The test is restarted "
+		"from scratch if it depends on the choices made in the cloud.",
+		ifOption::iotBool,
+		"false"
+		) )
+		return true;
+
+	// register "algebraicNRLimit" option -- 18/10/26
+	if ( KernelOptions.RegisterOption (
+		"algebraicNRLimit",
+		"Option 'algebraicNRLimit' sets the least N for which the at-least restriction (>= N R.C) creates a single "
+		"successor standing for all N of them. Such a successor is replaced with N nodes only if an at-most "
+		"restriction can't be checked arithmetically. It is not used with nominals, inverse roles and top role. "
+		"Value 0 switches it off.",
+		ifOption::iotInt,
+		"0"
+		) )
+		return true;
+
 	// options for Blocking
 
 	// register "useLazyBlocking" option -- 08-03-04
@@ -847,6 +1065,17 @@ bool ReasoningKernel :: initOptions ( void )
 		) )
 		return true;
 
+	// register "useIndividualGroups" option -- 19/10/26
+	if ( KernelOptions.RegisterOption (
+		"useIndividualGroups",
+		"Option 'useIndividualGroups' allows to realise individuals with the same description, the same related "
+		"individuals and the same different-individuals axioms once, and to give the result to all of them. "
+		"Individuals referenced as nominals are realised one by one.",
+		ifOption::iotBool,
+		"true"
+		) )
+		return true;
+
 	// options for kernel
 
 	// register "checkAD" option (24/02/2012)
@@ -32,9 +32,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tOntologyAtom.h"	// types for AD
 #include "ModuleType.h"
 #include "ModuleMethod.h"
+#include "tQueryCache.h"
 
 class OntologyBasedModularizer;
 class AtomicDecomposer;
+class TOntologyLoader;
 class TJNICache;	// cached JNI information
 class SaveLoadManager;
 
@@ -167,6 +169,10 @@ protected:	// members
 	TJNICache* JNICache;
 		/// name of an S/L context. do nothing if empty
 	SaveLoadManager* pSLManager;
+		/// loader that translates streamed assertions directly to the TBox
+	TOntologyLoader* pStreamLoader;
+		/// number of assertions loaded directly to the TBox bypassing the ontology
+	size_t nStreamedAxioms;
 
 	// Top/Bottom role names: if set, they will appear in all hierarchy-related output
 
@@ -185,6 +191,10 @@ protected:	// members
 	TProgressMonitor* pMonitor;
 		/// timeout value
 	unsigned long OpTimeout;
+		/// wall-clock time budget of a query in milliseconds; 0 means no limit
+	unsigned long QueryBudget;
+		/// wall-clock deadline of the current query
+	TDeadline QueryDeadline;
 		/// tell reasoner to use verbose output
 	bool verboseOutput;
 		/// allow reasoner to use undefined names in queries
@@ -192,15 +202,17 @@ protected:	// members
 
 	// reasoning cache
 
-		/// cache level
-	enum cacheStatus cacheLevel;
-		/// cached query input description
-	TConceptExpr* cachedQuery;
+		/// cache of the concept expression queries
+	TQueryCache QueryCache;
 		/// cached query concept description
 	DLTree* cachedQueryTree;
-		/// cached concept (either defConcept or existing one)
+		/// concept of the cached query description
+	TConcept* cachedTreeConcept;
+		/// query epoch of the cached query description
+	unsigned int cachedTreeEpoch;
+		/// concept of the last query (either defConcept or existing one)
 	TConcept* cachedConcept;
-		/// cached query result (taxonomy position)
+		/// taxonomy position of the last query
 	TaxonomyVertex* cachedVertex;
 
 	// internal flags
@@ -211,10 +223,18 @@ protected:	// members
 	bool NeedTracing;
 		/// ignore cache for the TExpr* (useful for semantic AD)
 	bool ignoreExprCache;
+		/// signature of the expression translator (if any); translation of the queries depends on it
+	const TSignature* QuerySig;
+		/// version of the translator signature for which the query cache is valid
+	unsigned int QuerySigVersion;
 		/// use incremental reasoning
 	bool useIncrementalReasoning;
 		/// flag to dump LISP-like ontology
 	bool dumpOntology;
+		/// load ABox assertions directly to the TBox without keeping them in the ontology
+	bool useStreamingLoad;
+		/// set if a streamed assertion made the KB inconsistent
+	bool streamedInconsistent;
 
 protected:	// methods
 
@@ -233,6 +253,16 @@ protected:	// methods
 	}
 		/// process KB wrt STATUS
 	void processKB ( KBStatus status );
+		/// ensure that KB is processed wrt STATUS and is consistent
+	void ensureKBStatus ( KBStatus status )
+	{
+		if ( getStatus() < status )
+			processKB(status);
+		if ( !isKBConsistent() )
+			throw EFPPInconsistentKB();
+	}
+		/// set the deadline of the query that starts now
+	void startQuery ( void ) { QueryDeadline.arm(QueryBudget); }
 		/// classify/realise KB only if it is impossible to load results
 	void ClassifyOrLoad ( bool needIndividuals );
 
@@ -259,29 +289,36 @@ protected:	// methods
 		/// clear query cache
 	void clearQueryCache ( void )
 	{
-		// clear cached query
-		cachedQuery = nullptr;
+		// clear cached queries
+		QueryCache.clear();
 		deleteTree(cachedQueryTree);
 		cachedQueryTree = nullptr;
+		cachedTreeConcept = nullptr;
 		// clear the rest of cache
-		cacheLevel = csEmpty;
 		cachedConcept = nullptr;
 		cachedVertex = nullptr;
 	}
-		/// @return true if the cache is not set
-	bool isCacheEmpty ( void ) const { return (cachedQuery == nullptr) && (cachedQueryTree == nullptr); }
-		/// set query cache value to QUERY
-	void setQueryCache ( TConceptExpr* query ) { fpp_assert(isCacheEmpty()); cachedQuery = query; }
-		/// set query cache value to QUERY
-	void setQueryCache ( DLTree* query ) { fpp_assert(isCacheEmpty()); cachedQueryTree = query; }
 		/// check whether query cache is the same as QUERY
-	bool checkQueryCache ( TConceptExpr* query ) const { return ignoreExprCache ? false : cachedQuery == query; }
-		/// check whether query cache is the same as QUERY
-	bool checkQueryCache ( DLTree* query ) const { return ignoreExprCache ? false : equalTrees ( cachedQueryTree, query ); }
+	bool checkQueryCache ( DLTree* query ) const
+	{
+		if ( ignoreExprCache || cachedTreeConcept == nullptr || cachedTreeEpoch != getTBox()->getQueryEpoch() )
+			return false;
+		return equalTrees ( cachedQueryTree, query );
+	}
+		/// remove the query concepts from the DAG keeping the taxonomy positions of the cached queries
+	void clearQueryDAG ( void );
 		/// set the query concept
 	void setQueryConcept ( const DLTree* query )
 	{	// setup cached concept depending on whether an entity is queries
-		cachedConcept = isCN(query) ? getTBox()->getCI(query) : getTBox()->createQueryConcept(query);
+		if ( isCN(query) )
+			cachedConcept = getTBox()->getCI(query);
+		else
+		{
+			// evicted queries stay in the DAG, so clear it from time to time
+			if ( getTBox()->getNQueryConcepts() > 2*QueryCache.getCapacity() )
+				clearQueryDAG();
+			cachedConcept = getTBox()->createQueryConcept(query);
+		}
 		fpp_assert ( cachedConcept != nullptr );
 		// preprocess concept is necessary (fresh concept in query or complex one)
 		if ( !isValid(cachedConcept->pName) )
@@ -506,6 +543,15 @@ protected:	// methods
 	bool needForceReload ( void ) const;
 		/// force the re-classification of the changed ontology
 	void forceReload ( void );
+		/// @return true iff the TBox is preprocessed, so nothing could be streamed to it
+	bool isTBoxPrepared ( void ) const
+		{ return pTBox != nullptr && ( pTBox->getStatus() != kbLoading || pTBox->isPrepared() ); }
+		/// @return true iff the TBox keeps streamed assertions and is preprocessed, so it can't be reloaded
+	bool isStreamedKBFixed ( void ) const { return nStreamedAxioms > 0 && isTBoxPrepared(); }
+		/// add AXIOM to the ontology; @return AXIOM
+	TDLAxiom* addAxiom ( TDLAxiom* axiom );
+		/// add an ABox assertion AXIOM to the ontology, or load it directly to the TBox in the streaming mode
+	TDLAxiom* addAssertion ( TDLAxiom* axiom );
 
 	//----------------------------------------------
 	//-- incremental reasoning support; implementation in Incremental.cpp
@@ -641,14 +687,55 @@ public:		// interface
 		if ( pTBox != nullptr )
 			pTBox->setTestTimeout(value);
 	}
+		/// give every query a wall-clock budget of MS milliseconds; 0 means no limit. The deadline is set when
+		/// a query starts, and a query still running at it throws EFPPTimeout; the KB stays usable, so the query
+		/// could be asked again. A query answered by the simpler ones (like isEquivalent()) gives the budget to each
+		/// of them. The budget includes the loading and classification of the KB done for the query.
+		/// NOTE: with streamed assertions (see setUseStreamingLoad()) the KB is lost if the time runs out before
+		/// its consistency check is done: all the later queries throw EFaCTPlusPlus until clearKB() is called
+	void setQueryDeadline ( unsigned long ms ) { QueryBudget = ms; QueryDeadline.clear(); }
+		/// remove the budget of the queries
+	void clearQueryDeadline ( void ) { setQueryDeadline(0); }
+		/// @return milliseconds left before the deadline of the current (or last) query; 0 if there is none or it has passed
+	unsigned long getQueryTimeLeft ( void ) const { return QueryDeadline.remaining(); }
+		/// make the running query throw EFPPTimeout as soon as possible; could be called from any thread.
+		/// The interrupt stays until the next setQueryDeadline() or clearQueryDeadline()
+	void interruptQuery ( void ) { QueryDeadline.interrupt(); }
 		/// choose whether TExpr cache should be ignored
 	void setIgnoreExprCache ( bool value ) { ignoreExprCache = value; }
+		/// set the number of concept expression queries kept in the query cache to VALUE (at least 1)
+	void setQueryCacheSize ( size_t value ) { QueryCache.setCapacity(value); }
+		/// @return the number of concept expression queries kept in the query cache
+	size_t getQueryCacheSize ( void ) const { return QueryCache.getCapacity(); }
+		/// @return the number of queries answered from the query cache
+	unsigned long long getQueryCacheHits ( void ) const { return QueryCache.getNHits(); }
+		/// @return the number of queries that were not answered from the query cache
+	unsigned long long getQueryCacheMisses ( void ) const { return QueryCache.getNMisses(); }
 		/// choose whether inctemental reasoning should be used
 	void setUseIncrementalReasoning ( bool value ) { useIncrementalReasoning = value; }
 		/// set the signature of the expression translator
-	void setSignature ( const TSignature* sig ) { if ( pET != nullptr ) pET->setSignature(sig); }
+	void setSignature ( const TSignature* sig )
+	{
+		if ( pET == nullptr )
+			return;
+		pET->setSignature(sig);
+		// cached queries are translated wrt the old signature
+		clearQueryCache();
+		QuerySig = sig;
+		QuerySigVersion = sig ? sig->getVersion() : 0;
+	}
 		/// choose whether the loaded ontology should be dumped as a LISP one
 	void setDumpOntology ( bool value ) { dumpOntology = value; }
+		/// choose whether ABox assertions (instanceOf, relatedTo, valueOf) should be streamed directly to the TBox.
+		/// Streamed assertions are not kept in the ontology: the tell methods return NULL for them, they can't be
+		/// retracted and are invisible to modularity, AD and incremental reasoning; complex expressions created since
+		/// the last non-streamed axiom are released after the assertion is loaded, so they should not be reused.
+		/// The TBox with streamed assertions can't be reloaded, so once any assertion was streamed, the ontology
+		/// is fixed by the first query: later tells and retracts throw EFaCTPlusPlus and leave the KB as it is.
+		/// Use clearKB() to start again.
+	void setUseStreamingLoad ( bool value ) { useStreamingLoad = value; }
+		/// @return number of assertions that were streamed directly to the TBox
+	size_t getNumStreamedAxioms ( void ) const { return nStreamedAxioms; }
 
 	//----------------------------------------------
 	//-- Tracing support
@@ -689,6 +776,7 @@ public:
 		pTBox = new TBox ( getOptions(), TopORoleName, BotORoleName, TopDRoleName, BotDRoleName );
 		pTBox->setTestTimeout(OpTimeout);
 		pTBox->setProgressMonitor(pMonitor);
+		pTBox->setDeadline(&QueryDeadline);
 		pTBox->setVerboseOutput(verboseOutput);
 		pTBox->setUseUndefinedNames(useUndefinedNames);
 		pET = new TExpressionTranslator(*pTBox);
@@ -700,6 +788,9 @@ public:
 	{
 		clearTBox();
 		Ontology.clear();
+		// streamed assertions were deleted together with the TBox
+		nStreamedAxioms = 0;
+		streamedInconsistent = false;
 		// the new KB is coming so the failures of the precious one doesn't matter
 		reasoningFailed = false;
 
@@ -720,116 +811,116 @@ public:
 	// Declaration axioms
 
 		/// axiom declare(x)
-	TDLAxiom* declare ( TExpr* C ) { return Ontology.add(new TDLAxiomDeclaration(C)); }
+	TDLAxiom* declare ( TExpr* C ) { return addAxiom(new TDLAxiomDeclaration(C)); }
 
 	// Concept axioms
 
 		/// axiom C [= D
 	TDLAxiom* impliesConcepts ( TConceptExpr* C, TConceptExpr* D )
-		{ return Ontology.add ( new TDLAxiomConceptInclusion ( C, D ) ); }
+		{ return addAxiom ( new TDLAxiomConceptInclusion ( C, D ) ); }
 		/// axiom C1 = ... = Cn
 	TDLAxiom* equalConcepts ( void )
-		{ return Ontology.add ( new TDLAxiomEquivalentConcepts(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomEquivalentConcepts(getExpressionManager()->getArgList()) ); }
 		/// axiom C1 != ... != Cn
 	TDLAxiom* disjointConcepts ( void )
-		{ return Ontology.add ( new TDLAxiomDisjointConcepts(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomDisjointConcepts(getExpressionManager()->getArgList()) ); }
 		/// axiom C = C1 or ... or Cn; C1 != ... != Cn
 	TDLAxiom* disjointUnion ( TConceptExpr* C )
-		{ return Ontology.add ( new TDLAxiomDisjointUnion ( C, getExpressionManager()->getArgList() ) ); }
+		{ return addAxiom ( new TDLAxiomDisjointUnion ( C, getExpressionManager()->getArgList() ) ); }
 
 
 	// Role axioms
 
 		/// R = Inverse(S)
 	TDLAxiom* setInverseRoles ( TORoleExpr* R, TORoleExpr* S )
-		{ return Ontology.add ( new TDLAxiomRoleInverse(R,S) ); }
+		{ return addAxiom ( new TDLAxiomRoleInverse(R,S) ); }
 		/// axiom (R [= S)
 	TDLAxiom* impliesORoles ( TORoleComplexExpr* R, TORoleExpr* S )
-		{ return Ontology.add ( new TDLAxiomORoleSubsumption ( R, S ) ); }
+		{ return addAxiom ( new TDLAxiomORoleSubsumption ( R, S ) ); }
 		/// axiom (R [= S)
 	TDLAxiom* impliesDRoles ( TDRoleExpr* R, TDRoleExpr* S )
-		{ return Ontology.add ( new TDLAxiomDRoleSubsumption ( R, S ) ); }
+		{ return addAxiom ( new TDLAxiomDRoleSubsumption ( R, S ) ); }
 		/// axiom R1 = R2 = ...
 	TDLAxiom* equalORoles ( void )
-		{ return Ontology.add ( new TDLAxiomEquivalentORoles(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomEquivalentORoles(getExpressionManager()->getArgList()) ); }
 		/// axiom R1 = R2 = ...
 	TDLAxiom* equalDRoles ( void )
-		{ return Ontology.add ( new TDLAxiomEquivalentDRoles(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomEquivalentDRoles(getExpressionManager()->getArgList()) ); }
 		/// axiom R1 != R2 != ...
 	TDLAxiom* disjointORoles ( void )
-		{ return Ontology.add ( new TDLAxiomDisjointORoles(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomDisjointORoles(getExpressionManager()->getArgList()) ); }
 		/// axiom R1 != R2 != ...
 	TDLAxiom* disjointDRoles ( void )
-		{ return Ontology.add ( new TDLAxiomDisjointDRoles(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomDisjointDRoles(getExpressionManager()->getArgList()) ); }
 
 		/// Domain (R C)
 	TDLAxiom* setODomain ( TORoleExpr* R, TConceptExpr* C )
-		{ return Ontology.add ( new TDLAxiomORoleDomain ( R, C ) ); }
+		{ return addAxiom ( new TDLAxiomORoleDomain ( R, C ) ); }
 		/// Domain (R C)
 	TDLAxiom* setDDomain ( TDRoleExpr* R, TConceptExpr* C )
-		{ return Ontology.add ( new TDLAxiomDRoleDomain ( R, C ) ); }
+		{ return addAxiom ( new TDLAxiomDRoleDomain ( R, C ) ); }
 		/// Range (R C)
 	TDLAxiom* setORange ( TORoleExpr* R, TConceptExpr* C )
-		{ return Ontology.add ( new TDLAxiomORoleRange ( R, C ) ); }
+		{ return addAxiom ( new TDLAxiomORoleRange ( R, C ) ); }
 		/// Range (R E)
 	TDLAxiom* setDRange ( TDRoleExpr* R, TDataExpr* E )
-		{ return Ontology.add ( new TDLAxiomDRoleRange ( R, E ) ); }
+		{ return addAxiom ( new TDLAxiomDRoleRange ( R, E ) ); }
 
 		/// Transitive (R)
 	TDLAxiom* setTransitive ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomRoleTransitive(R) ); }
+		{ return addAxiom ( new TDLAxiomRoleTransitive(R) ); }
 		/// Reflexive (R)
 	TDLAxiom* setReflexive ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomRoleReflexive(R) ); }
+		{ return addAxiom ( new TDLAxiomRoleReflexive(R) ); }
 		/// Irreflexive (R): Domain(R) = \neg ER.Self
 	TDLAxiom* setIrreflexive ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomRoleIrreflexive(R) ); }
+		{ return addAxiom ( new TDLAxiomRoleIrreflexive(R) ); }
 		/// Symmetric (R): R [= R^-
 	TDLAxiom* setSymmetric ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomRoleSymmetric(R) ); }
+		{ return addAxiom ( new TDLAxiomRoleSymmetric(R) ); }
 		/// Asymmetric (R): disjoint(R,R^-)
 	TDLAxiom* setAsymmetric ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomRoleAsymmetric(R) ); }
+		{ return addAxiom ( new TDLAxiomRoleAsymmetric(R) ); }
 		/// Functional (R)
 	TDLAxiom* setOFunctional ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomORoleFunctional(R) ); }
+		{ return addAxiom ( new TDLAxiomORoleFunctional(R) ); }
 		/// Functional (R)
 	TDLAxiom* setDFunctional ( TDRoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomDRoleFunctional(R) ); }
+		{ return addAxiom ( new TDLAxiomDRoleFunctional(R) ); }
 		/// InverseFunctional (R)
 	TDLAxiom* setInverseFunctional ( TORoleExpr* R )
-		{ return Ontology.add ( new TDLAxiomRoleInverseFunctional(R) ); }
+		{ return addAxiom ( new TDLAxiomRoleInverseFunctional(R) ); }
 
 
 	// Individual axioms
 
-		/// axiom I e C
+		/// axiom I e C; @return nullptr if the assertion was streamed
 	TDLAxiom* instanceOf ( TIndividualExpr* I, TConceptExpr* C )
-		{ return Ontology.add ( new TDLAxiomInstanceOf(I,C) ); }
-		/// axiom <I,J>:R
+		{ return addAssertion ( new TDLAxiomInstanceOf(I,C) ); }
+		/// axiom <I,J>:R; @return nullptr if the assertion was streamed
 	TDLAxiom* relatedTo ( TIndividualExpr* I, TORoleExpr* R, TIndividualExpr* J )
-		{ return Ontology.add ( new TDLAxiomRelatedTo(I,R,J) ); }
+		{ return addAssertion ( new TDLAxiomRelatedTo(I,R,J) ); }
 		/// axiom <I,J>:\neg R
 	TDLAxiom* relatedToNot ( TIndividualExpr* I, TORoleExpr* R, TIndividualExpr* J )
-		{ return Ontology.add ( new TDLAxiomRelatedToNot(I,R,J) ); }
-		/// axiom (value I A V)
+		{ return addAxiom ( new TDLAxiomRelatedToNot(I,R,J) ); }
+		/// axiom (value I A V); @return nullptr if the assertion was streamed
 	TDLAxiom* valueOf ( TIndividualExpr* I, TDRoleExpr* A, TDataValueExpr* V )
-		{ return Ontology.add ( new TDLAxiomValueOf(I,A,V) ); }
+		{ return addAssertion ( new TDLAxiomValueOf(I,A,V) ); }
 		/// axiom <I,V>:\neg A
 	TDLAxiom* valueOfNot ( TIndividualExpr* I, TDRoleExpr* A, TDataValueExpr* V )
-		{ return Ontology.add ( new TDLAxiomValueOfNot(I,A,V) ); }
+		{ return addAxiom ( new TDLAxiomValueOfNot(I,A,V) ); }
 		/// same individuals
 	TDLAxiom* processSame ( void )
-		{ return Ontology.add ( new TDLAxiomSameIndividuals(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomSameIndividuals(getExpressionManager()->getArgList()) ); }
 		/// different individuals
 	TDLAxiom* processDifferent ( void )
-		{ return Ontology.add ( new TDLAxiomDifferentIndividuals(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomDifferentIndividuals(getExpressionManager()->getArgList()) ); }
 		/// let all concept expressions in the ArgQueue to be fairness constraints
 	TDLAxiom* setFairnessConstraint ( void )
-		{ return Ontology.add ( new TDLAxiomFairnessConstraint(getExpressionManager()->getArgList()) ); }
+		{ return addAxiom ( new TDLAxiomFairnessConstraint(getExpressionManager()->getArgList()) ); }
 
 		/// retract an axiom
-	void retract ( TDLAxiom* axiom ) { Ontology.retract(axiom); }
+	void retract ( TDLAxiom* axiom );
 
 	//******************************************
 	//* ASK part
@@ -855,24 +946,20 @@ public:
 		/// ensure that KB is preprocessed/consistence checked
 	void preprocessKB ( void )
 	{
-		if ( !isKBConsistent() )
-			throw EFPPInconsistentKB();
+		startQuery();
+		ensureKBStatus(kbCChecked);
 	}
 		/// ensure that KB is classified
 	void classifyKB ( void )
 	{
-		if ( !isKBClassified() )
-			processKB(kbClassified);
-		if ( !isKBConsistent() )
-			throw EFPPInconsistentKB();
+		startQuery();
+		ensureKBStatus(kbClassified);
 	}
 		/// ensure that KB is realised
 	void realiseKB ( void )
 	{
-		if ( !isKBRealised() )
-			processKB(kbRealised);
-		if ( !isKBConsistent() )
-			throw EFPPInconsistentKB();
+		startQuery();
+		ensureKBStatus(kbRealised);
 	}
 
 	// role info retrieval
@@ -1354,9 +1441,21 @@ public:
 
 		/// get a module of an ontology wrt given method.
 	const AxiomVec& getModule ( ModuleMethod moduleMethod, ModuleType moduleType );
+		/// get modules of an ontology wrt given method and type for all the SIGNATURES; use up to NTHREADS threads
+	void getModules ( ModuleMethod moduleMethod, ModuleType moduleType, const std::vector<TSignature>& signatures,
+					  std::vector<AxiomVec>& modules, unsigned int nThreads = 1 );
 		/// get a set of non-local axioms of an ontology wrt given method.
 	const AxiomVec& getNonLocal ( ModuleMethod moduleMethod, ModuleType moduleType );
 
+	//----------------------------------------------------------------------------------
+	// binary axiom streams
+	//----------------------------------------------------------------------------------
+
+		/// add all the axioms from the binary axiom stream I to the ontology; nothing is added if the stream is malformed. @return number of added axioms
+	size_t loadAxiomStream ( std::istream& i );
+		/// write all the axioms of the ontology to O as a binary axiom stream
+	void saveAxiomStream ( std::ostream& o ) const;
+
 	//----------------------------------------------------------------------------------
 	// save/load interface
 	//----------------------------------------------------------------------------------
@@ -68,7 +68,7 @@ public:		// interface
 	virtual ~LocalityChecker ( void ) {}
 
 		/// @return true iff an AXIOM is local wrt signature
-	bool local ( const TDLAxiom* axiom )
+	virtual bool local ( const TDLAxiom* axiom )
 	{
 		axiom->accept(*this);
 		return isLocal;
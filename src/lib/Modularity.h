@@ -58,6 +58,8 @@ protected:	// members
 	unsigned long long nNonLocal;
 		/// true if no atoms are processed ATM
 	bool noAtomsProcessing;
+		/// module extraction method
+	ModuleMethod Method;
 
 protected:	// methods
 		/// update SIG wrt the axiom signature
@@ -111,6 +113,21 @@ protected:	// methods
 		for ( SigIndex::const_iterator q = AxSet.begin(), q_end = AxSet.end(); q != q_end; ++q )
 			if ( !(*q)->isInModule() && (*q)->isInSS() ) // in the given range but not in module yet
 				addNonLocal ( *q, noCheck );
+	}
+		/// add all the axioms from AxSet that became non-local as ENTITY joined the signature; use COMPILED locality wrt top-locality TOP
+	void addNonLocal ( const AxiomVec& AxSet, const TNamedEntity* entity, CompiledLocality* compiled, bool top )
+	{
+		for ( SigIndex::const_iterator q = AxSet.begin(), q_end = AxSet.end(); q != q_end; ++q )
+			if ( !(*q)->isInModule() && (*q)->isInSS() ) // in the given range but not in module yet
+			{
+				if ( unlikely(!compiled->isCompiled(*q,top)) )
+					addNonLocal ( *q, /*noCheck=*/false );
+				else if ( compiled->addEntity ( *q, top, entity ) )
+				{
+					++nNonLocal;
+					addNonLocal ( *q, /*noCheck=*/true );
+				}
+			}
 	}
 		/// build a module traversing axioms by a signature
 	void extractModuleQueue ( void )
@@ -120,13 +137,21 @@ protected:	// methods
 			WorkQueue.push(*p);
 		// add all the axioms that are non-local wrt given value of a top-locality
 		addNonLocal ( sigIndex.getNonLocal(sig.topCLocal()), /*noCheck=*/true );
+		// use compiled locality if it is there and matches the locality class
+		bool top = sig.topCLocal();
+		CompiledLocality* compiled = sig.topRLocal() == top ? sigIndex.getCompiledLocality() : nullptr;
+		if ( compiled != nullptr )
+			compiled->newPass();
 		// main cycle
 		while ( !WorkQueue.empty() )
 		{
 			const TNamedEntity* entity = WorkQueue.front();
 			WorkQueue.pop();
 			// for all the axioms that contains entity in their signature
-			addNonLocal ( sigIndex.getAxioms(entity), /*noCheck=*/false );
+			if ( compiled != nullptr )
+				addNonLocal ( sigIndex.getAxioms(entity), entity, compiled, top );
+			else
+				addNonLocal ( sigIndex.getAxioms(entity), /*noCheck=*/false );
 		}
 	}
 		/// extract module wrt presence of a sig index
@@ -151,10 +176,11 @@ public:		// interface
 		/// init c'tor
 	TModularizer ( ModuleMethod moduleMethod )
 		: Checker(createLocalityChecker(moduleMethod,&sig))
-		, sigIndex(Checker)
+		, sigIndex(Checker,/*compile=*/moduleMethod==SYN_LOC_STD)
 		, nChecks(0)
 		, nNonLocal(0)
 		, noAtomsProcessing(true)
+		, Method(moduleMethod)
 		{}
 		// d'tor
 	~TModularizer ( void ) { delete Checker; }
@@ -216,6 +242,10 @@ public:		// interface
 
 		/// get RW access to the sigIndex (mainly to (un-)register axioms on the fly)
 	SigIndex* getSigIndex ( void ) { return &sigIndex; }
+		/// get RO access to the sigIndex
+	const SigIndex& getSigIndex ( void ) const { return sigIndex; }
+		/// get the module extraction method
+	ModuleMethod getModuleMethod ( void ) const { return Method; }
 
 		/// get the last computed module
 	const AxiomVec& getModule ( void ) const { return Module; }
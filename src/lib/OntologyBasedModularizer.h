@@ -19,7 +19,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ONTOLOGYBASEDMODULARIZER_H
 #define ONTOLOGYBASEDMODULARIZER_H
 
-#include "Modularity.h"
+#include "BatchModularizer.h"
 #include "tOntology.h"
 
 class OntologyBasedModularizer
@@ -29,17 +29,20 @@ protected:	// members
 	const TOntology& Ontology;
 		/// pointer to a modularizer
 	TModularizer* Modularizer;
+		/// extractor of many modules at once; created on demand
+	BatchModularizer* Batch;
 
 public:		// interface
 		/// init c'tor
 	OntologyBasedModularizer ( const TOntology& ontology, ModuleMethod moduleMethod )
 		: Ontology(ontology)
+		, Batch(nullptr)
 	{
 		Modularizer = new TModularizer(moduleMethod);
 		Modularizer->preprocessOntology(Ontology.getAxioms());
 	}
 		/// d'tor
-	~OntologyBasedModularizer ( void ) { delete Modularizer; }
+	~OntologyBasedModularizer ( void ) { delete Batch; delete Modularizer; }
 
 		/// get module
 	const AxiomVec& getModule ( const AxiomVec& From, const TSignature& sig, ModuleType type )
@@ -50,6 +53,13 @@ public:		// interface
 		/// get module
 	const AxiomVec& getModule ( const TSignature& sig, ModuleType type )
 		{ return getModule ( Ontology.getAxioms(), sig, type ); }
+		/// get modules of TYPE for all SIGNATURES into MODULES using up to NTHREADS threads
+	void getModules ( const std::vector<TSignature>& signatures, ModuleType type, std::vector<AxiomVec>& modules, unsigned int nThreads = 1 )
+	{
+		if ( Batch == nullptr )
+			Batch = new BatchModularizer ( *Modularizer, Ontology.getAxioms() );
+		Batch->extract ( signatures, type, modules, nThreads );
+	}
 		/// get access to a modularizer
 	TModularizer* getModularizer ( void ) { return Modularizer; }
 }; // OntologyBasedModularizer
@@ -16,6 +16,7 @@ License along with this library; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+#include <algorithm>
 #include <iomanip>
 
 #include "Reasoner.h"
@@ -41,12 +42,19 @@ DlSatTester :: DlSatTester ( TBox& tbox )
 	// It's unsafe to have a cache that touches a nominal in a node; set flagNominals to prevent it
 	, newNodeCache ( true, tBox.nC, tBox.nR )
 	, newNodeEdges ( false, tBox.nC, tBox.nR )
+	, LabelCache(4096)
+	, LabelTester(nullptr)
+	, isLabelTester(false)
 	, GCIs(tbox.GCIs)
 	, bContext(nullptr)
 	, tryLevel(InitBranchingLevelValue)
 	, nonDetShift(0)
+	, frozenLevel(0)
+	, frozenClash(false)
+	, Nogoods(4096)
 	, curNode(nullptr)
 	, dagSize(0)
+	, pPoolCancelled(nullptr)
 {
 	// init static part of CTree
 	CGraph.initContext ( tBox.nSkipBeforeBlock, tBox.useLazyBlocking, tBox.useAnywhereBlocking );
@@ -75,6 +83,7 @@ DlSatTester :: prepareReasoner ( void )
 	curNode = nullptr;
 	bContext = nullptr;
 	tryLevel = InitBranchingLevelValue;
+	Nogoods.stopTest();
 
 	// clear last session information
 	resetSessionFlags();
@@ -177,8 +186,7 @@ DlSatTester :: addToDoEntry ( DlCompletionTree* node, const ConceptWDep& C, cons
 		return true;
 	}
 
-	const DLVertex& v = DLHeap[C];
-	DagTag tag = v.Type();
+	DagTag tag = DLHeap.getTag(C);
 
 	// try to add a concept to a node label
 	switch ( tryAddConcept ( node->label().getLabel(tag), C.bp(), C.getDep() ) )
@@ -336,6 +344,7 @@ DlSatTester :: reportNodeCached ( DlCompletionTree* node )
 {
 	doCacheNode(node);
 	enum modelCacheState status = newNodeCache.getState();
+	LOG_EVENT ( evNodeCache, status, node->getId(), 0 );
 	switch ( status )
 	{
 	case csValid:
@@ -359,6 +368,79 @@ DlSatTester :: reportNodeCached ( DlCompletionTree* node )
 	return status;
 }
 
+modelCacheState
+DlSatTester :: tryLabelCache ( DlCompletionTree* node )
+{
+	// nominal and data nodes can not be cached
+	if ( node->isNominalNode() || node->isDataNode() )
+		return csFailed;
+
+	NodeLabel.clear();
+	DepSet dep;
+	DlCompletionTree::const_label_iterator p;
+
+	for ( p = node->beginl_sc(); p != node->endl_sc(); ++p )
+	{
+		NodeLabel.push_back(p->bp());
+		dep.add(p->getDep());
+	}
+	for ( p = node->beginl_cc(); p != node->endl_cc(); ++p )
+	{
+		NodeLabel.push_back(p->bp());
+		dep.add(p->getDep());
+	}
+
+	// query entries could change their meaning later
+	for ( const auto& C: NodeLabel )
+		if ( DLHeap.isQueryEntry(C) )
+			return csFailed;
+	if ( NodeLabel.empty() )
+		return csFailed;
+
+	std::sort ( NodeLabel.begin(), NodeLabel.end() );
+	TLabelSatCache::Entry& entry = LabelCache.get(NodeLabel);
+
+	if ( entry.Cache == nullptr )
+	{
+		// a single occurrence of the label is cheaper to expand in place
+		if ( ++entry.nSeen < 2 )
+			return csFailed;
+
+		// test the label separately; its concepts are in the relevant part of the KB for the current test
+		if ( LabelTester == nullptr )
+		{
+			LabelTester = new DlSatTester(tBox);
+			LabelTester->isLabelTester = true;
+		}
+		incStat(nLabelCacheTests);
+		LabelTester->setBlockingMethod ( tBox.isIRinQuery(), tBox.isNRinQuery() );
+		entry.Cache = LabelTester->buildCacheByCGraph(LabelTester->runSat(NodeLabel));
+	}
+
+	// the label is unsatisfiable: the clash depends on all its concepts
+	if ( entry.Cache->getState() == csInvalid )
+	{
+		incStat(nLabelCacheHits);
+		incStat(nCachedUnsat);
+		setClashSet(dep);
+		return csInvalid;
+	}
+
+	// the model of the label should be compatible with the edges of the node
+	newNodeCache.clear();
+	newNodeCache.merge(entry.Cache);
+	newNodeEdges.clear();
+	newNodeEdges.initRolesFromArcs(node);
+	if ( newNodeCache.merge(&newNodeEdges) != csValid )
+		return csFailed;
+
+	incStat(nLabelCacheHits);
+	incStat(nCachedSat);
+	if ( LLM.isWritable(llGTA) )
+		LL << " cached(" << node->getId() << ",l)";
+	return csValid;
+}
+
 bool DlSatTester :: correctCachedEntry ( DlCompletionTree* n )
 {
 	fpp_assert ( n->isCached() );	// safety check
@@ -393,12 +475,33 @@ DlSatTester :: hasDataClash ( const DlCompletionTree* Node )
 	return false;
 }
 
+bool
+DlSatTester :: runSat ( const TLabelSatCache::Label& label )
+{
+	prepareReasoner();
+
+	// use general method to init node with the 1st concept and add the rest then
+	DlCompletionTree* root = CGraph.getRoot();
+	if ( initNewNode ( root, DepSet(), label.front() ) )
+		return false;
+	for ( TLabelSatCache::Label::const_iterator p = label.begin()+1, p_end = label.end(); p < p_end; ++p )
+		if ( addToDoEntry ( root, ConceptWDep(*p) ) )
+			return false;
+
+	satTimer.Start();
+	bool result = runSat();
+	satTimer.Stop();
+	return result;
+}
+
 bool DlSatTester :: runSat ( void )
 {
 	testTimer.Start();
 	bool result = checkSatisfiability ();
 	testTimer.Stop();
 
+	LOG_EVENT ( evSatFinish, 0, result, 1000000*(float)testTimer );
+
 	if ( LLM.isWritable(llSatTime) )
 		LL << "\nChecking time was " << testTimer << " seconds";
 
@@ -474,12 +577,14 @@ bool DlSatTester :: checkSatisfiability ( void )
 		if ( ++loop == 5000 )
 		{
 			loop = 0;
-			if ( tBox.isCancelled() )
+			if ( isCancelled() )
 				return false;
 			unsigned long timeout = getSatTimeout();
 			if ( unlikely(timeout > 0) && 1000*(float)testTimer >= timeout )
 				throw EFPPTimeout();
 		}
+		// the wall-clock deadline is cheap to check, so do it for every rule
+		checkDeadline();
 		// here curNode/curConcept are set
 		if ( commonTactic() )	// clash found
 		{
@@ -584,6 +689,8 @@ void DlSatTester :: restore ( unsigned int newTryLevel )
 	fpp_assert ( !Stack.empty () );
 	fpp_assert ( newTryLevel > 0 );
 
+	LOG_EVENT ( evBacktrack, 0, newTryLevel, getCurLevel() );
+
 	// skip all intermediate restores
 	setCurLevel(newTryLevel);
 
@@ -606,6 +713,57 @@ void DlSatTester :: restore ( unsigned int newTryLevel )
 #endif
 }
 
+void DlSatTester :: learnNogood ( const DepSet& dep )
+{
+	ClashLevels.clear();
+	dep.getLevels(ClashLevels);
+	NogoodConcepts.clear();
+
+	for ( const auto& level: ClashLevels )
+	{
+		// only the disjunction choices in the root are independent of the particular nodes
+		const BranchingContext* bc = Stack.get(level);
+		if ( bc->getKind() != bckOr || bc->curNode != CGraph.getRoot() )
+			return;
+
+		// the chosen disjunct and the negations of the failed ones are in the root label
+		const BCOr& bcOr = bc->getOr();
+		NogoodConcepts.push_back(*bcOr.orCur());
+		if ( useSemanticBranching() )
+			for ( BCOr::or_iterator p = bcOr.orBeg(), p_end = bcOr.orCur(); p < p_end; ++p )
+				NogoodConcepts.push_back(inverse(*p));
+
+		// long nogoods are rarely repeated
+		if ( NogoodConcepts.size() > 8 )
+			return;
+	}
+
+	// query entries could change their meaning later
+	for ( const auto& C: NogoodConcepts )
+		if ( DLHeap.isQueryEntry(C) )
+			return;
+
+	if ( Nogoods.add(NogoodConcepts) )
+	{
+		incStat(nNogoodsLearned);
+	}
+}
+
+void DlSatTester :: bumpActivity ( const DepSet& dep )
+{
+	ClashLevels.clear();
+	dep.getLevels(ClashLevels);
+
+	for ( const auto& level: ClashLevels )
+	{
+		const BranchingContext* bc = Stack.get(level);
+		if ( bc->getKind() == bckOr )
+			Activity.bump(*bc->getOr().orCur());
+	}
+
+	Activity.decay();
+}
+
 /**
   * logging methods
   */
@@ -658,10 +816,14 @@ void DlSatTester :: logStatisticData ( std::ostream& o, bool needLocal ) const
 	nFuncCalls.Print	( o, needLocal, "\n    Func operations: ", "" );
 	nLeCalls.Print		( o, needLocal, "\n    LE   operations: ", "" );
 	nGeCalls.Print		( o, needLocal, "\n    GE   operations: ", "" );
+	nGeProxyCalls.Print	( o, needLocal, "\n           including ", " ones with a proxy node" );
 	nUseless.Print		( o, needLocal, "\n    N/A  operations: ", "" );
 
 	nNNCalls.Print		( o, needLocal, "\nThere were made ", " NN rule application" );
 	nMergeCalls.Print	( o, needLocal, "\nThere were made ", " merging operations" );
+	nProxyExpansions.Print	( o, needLocal, "\nThere were made ", " proxy node expansions" );
+	nNogoodsLearned.Print	( o, needLocal, "\nThere were learned ", " nogoods" );
+	nNogoodPrunes.Print		( o, needLocal, "\nThere were pruned ", " disjunction choices that repeat a nogood" );
 
 	nAutoEmptyLookups.Print	( o, needLocal, "\nThere were made ", " RA empty transition lookups" );
 	nAutoTransLookups.Print	( o, needLocal, "\nThere were made ", " RA applicable transition lookups" );
@@ -684,6 +846,8 @@ void DlSatTester :: logStatisticData ( std::ostream& o, bool needLocal ) const
 	nCacheFailed.Print			( o, needLocal, "\n                ", " fails due to cache merge failure" );
 	nCachedSat.Print			( o, needLocal, "\n                ", " cached satisfiable nodes" );
 	nCachedUnsat.Print			( o, needLocal, "\n                ", " cached unsatisfiable nodes" );
+	nLabelCacheTests.Print		( o, needLocal, "\nThere were made ", " separate tests of the repeated node labels" );
+	nLabelCacheHits.Print		( o, needLocal, "\nThere were ", " nodes cached by the satisfiability of their labels" );
 #endif
 
 	if ( !needLocal )
@@ -19,6 +19,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef REASONER_H
 #define REASONER_H
 
+#include <atomic>
+
 #include "globaldef.h"
 #include "tBranchingContext.h"
 #include "dlCompletionGraph.h"
@@ -30,6 +32,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DataReasoning.h"
 #include "ToDoList.h"
 #include "tFastSet.h"
+#include "tNogoodStore.h"
+#include "tLabelSatCache.h"
+#include "EventLog.h"
 
 #ifdef _USE_LOGGING	// don't gather statistics w/o logging
 #	define USE_REASONING_STATISTICS
@@ -138,76 +143,44 @@ protected:	// constants
 	const unsigned int redoEverything = redoForall | redoFunc | redoAtMost | redoIrr;
 
 protected:	// classes
-		/// stack to keep BContext
+		/// stack to keep BContext; the contexts are slots that are re-used by the rules of all kinds, so push and pop are index moves
 	class BCStack: public TSaveStack<BranchingContext>
 	{
-	protected:	// members
-			/// pool for OR contexts
-		DeletelessAllocator<BCOr> PoolOr;
-			/// pool for NN contexts
-		DeletelessAllocator<BCNN> PoolNN;
-			/// pool for LE contexts
-		DeletelessAllocator<BCLE<DlCompletionTreeArc> > PoolLE;
-			/// pool for Top-LE contexts
-		DeletelessAllocator<BCLE<DlCompletionTree> > PoolTopLE;
-			/// pool for Choose contexts
-		DeletelessAllocator<BCChoose> PoolCh;
-			/// single entry for the barrier (good for nominal reasoner)
-		BCBarrier* bcBarrier;
-
 	protected:	// methods
-			/// specialise new method as the one doing nothing
-		virtual BranchingContext* createNew ( void ) { return nullptr; }
-			/// push method to use
-		BranchingContext* push ( BranchingContext* p )
+			/// push a context for the rule of a KIND
+		BranchingContext* push ( BCKind kind )
 		{
-			p->init();
-			TSaveStack<BranchingContext>::push();
-			this->Base[this->last-1] = p;
+			BranchingContext* p = TSaveStack<BranchingContext>::push();
+			p->init(kind);
 			return p;
 		}
 
 	public:		// interface
 			/// empty c'tor
-		BCStack ( void ) : bcBarrier(new BCBarrier) {}
+		BCStack ( void ) {}
 			/// empty d'tor
-		virtual ~BCStack ( void )
-		{
-			// all the members will be deleted in the resp. pools
-			for ( iterator p = this->Base.begin(), p_end = this->Base.end(); p < p_end; ++p )
-				*p = nullptr;
-			delete bcBarrier;
-		}
+		virtual ~BCStack ( void ) {}
 
 		// push methods
 
 			/// get BC for Or-rule
-		BranchingContext* pushOr ( void ) { return push(PoolOr.get()); }
+		BranchingContext* pushOr ( void ) { return push(bckOr); }
 			/// get BC for NN-rule
-		BranchingContext* pushNN ( void ) { return push(PoolNN.get()); }
+		BranchingContext* pushNN ( void ) { return push(bckNN); }
 			/// get BC for LE-rule
-		BranchingContext* pushLE ( void ) { return push(PoolLE.get()); }
+		BranchingContext* pushLE ( void ) { return push(bckLE); }
 			/// get BC for TopLE-rule
-		BranchingContext* pushTopLE ( void ) { return push(PoolTopLE.get()); }
+		BranchingContext* pushTopLE ( void ) { return push(bckTopLE); }
 			/// get BC for Choose-rule
-		BranchingContext* pushCh ( void ) { return push(PoolCh.get()); }
+		BranchingContext* pushCh ( void ) { return push(bckChoose); }
 			/// get BC for the barrier
-		BranchingContext* pushBarrier ( void ) { return push(bcBarrier); }
+		BranchingContext* pushBarrier ( void ) { return push(bckBarrier); }
 
-			/// clear all the pools
-		void clearPools ( void )
-		{
-			PoolOr.clear();
-			PoolNN.clear();
-			PoolLE.clear();
-			PoolTopLE.clear();
-			PoolCh.clear();
-		}
-			/// clear the stack and pools
-		virtual void clear ( void )
+			/// @return the context of the branching LEVEL without changing the stack
+		const BranchingContext* get ( unsigned int level ) const
 		{
-			clearPools();
-			TSaveStack<BranchingContext>::clear();
+			fpp_assert ( level > 0 && level <= this->last );
+			return this->Base[level-1];
 		}
 	}; // BCStack
 
@@ -233,6 +206,14 @@ protected:	// members
 	modelCacheIan newNodeCache;
 		/// auxilliary cache that is built from the edges of newly created node
 	modelCacheIan newNodeEdges;
+		/// satisfiability of the node labels that were met in the earlier tests
+	TLabelSatCache LabelCache;
+		/// sorted label of the node being cached
+	TLabelSatCache::Label NodeLabel;
+		/// reasoner for the tests of the labels; created on demand
+	DlSatTester* LabelTester;
+		/// true iff the reasoner is the label tester of another one
+	bool isLabelTester;
 
 		/// GCI-related KB flags
 	const TKBFlags& GCIs;
@@ -257,6 +238,18 @@ protected:	// members
 	unsigned int tryLevel;
 		/// shift in order to determine the 1st non-det application
 	unsigned int nonDetShift;
+		/// all the branching points on this level and below are frozen in a snapshot; 0 if there is no snapshot
+	unsigned int frozenLevel;
+		/// true iff the last test was decided by a clash that depends on the frozen branching points
+	bool frozenClash;
+		/// nogoods learned from the clashes of the disjunction choices in the root
+	TNogoodStore Nogoods;
+		/// concepts of the nogood being learned or checked
+	TNogoodStore::ConceptSet NogoodConcepts;
+		/// levels of the clash set the nogood is learned from (or the activity is bumped by)
+	std::vector<unsigned int> ClashLevels;
+		/// activity scores of the disjuncts; used by the dynamic OR order
+	TActivityScores Activity;
 
 	// statistic elements
 
@@ -275,6 +268,10 @@ protected:	// members
 		nFuncCalls,
 		nLeCalls,
 		nGeCalls,
+		nGeProxyCalls,
+		nProxyExpansions,
+		nNogoodsLearned,
+		nNogoodPrunes,
 
 		nNNCalls,
 		nMergeCalls,
@@ -300,7 +297,9 @@ protected:	// members
 		nCacheFailedShallow,
 		nCacheFailed,
 		nCachedSat,
-		nCachedUnsat;
+		nCachedUnsat,
+		nLabelCacheTests,
+		nLabelCacheHits;
 #endif
 
 	// current values
@@ -314,6 +313,8 @@ protected:	// members
 
 		/// size of the DAG with some extra space
 	size_t dagSize;
+		/// cancellation flag of the task pool if the reasoner is its worker; NULL otherwise
+	const std::atomic<bool>* pPoolCancelled;
 
 		/// temporary array used in OR operation
 	BCOr::OrIndex OrConceptsToTest;
@@ -350,6 +351,16 @@ protected:	// methods
 	bool useSemanticBranching ( void ) const { return tBox.useSemanticBranching; }
 		/// @return true iff lazy blocking is used
 	bool useLazyBlocking ( void ) const { return tBox.useLazyBlocking; }
+		/// @return true iff at-least restrictions might be represented by proxy nodes
+	bool useAlgebraicNR ( void ) const { return tBox.algebraicNRLimit != 0; }
+		/// @return true iff nogoods are learned and used; they need the clash sets and a single root
+	bool useNogoods ( void ) const { return tBox.useNogoods && tBox.useBackjumping && !hasNominals(); }
+		/// @return true iff the labels might be cached; the label tests don't know about nominals and session GCIs
+	bool useLabelCache ( void ) const
+	{
+		return tBox.useLabelCache && tBox.useNodeCache && !isLabelTester && !hasNominals()
+			&& !tBox.testHasNominals() && !tBox.testHasTopRole() && SessionGCIs.empty();
+	}
 
 		/// reset all session flags
 	void resetSessionFlags ( void );
@@ -419,7 +430,7 @@ protected:	// methods
 	{
 		const ConceptWDep& C = node->label().getConcept(offset);
 		auto bp = C.bp();
-		TODO.addEntry ( node, DLHeap[bp].Type(), bp, offset );
+		TODO.addEntry ( node, DLHeap.getTag(bp), bp, offset );
 		if ( LLM.isWritable(llGTA) )
 			logEntry ( node, C, reason );
 	}
@@ -467,10 +478,14 @@ protected:	// methods
 	void doCacheNode ( DlCompletionTree* node );
 		/// mark NODE (un)cached depending on the joint cache STATUS; @return resulting status
 	modelCacheState reportNodeCached ( DlCompletionTree* node );
+		/// check whether the label of NODE is known to be (un)satisfiable; @return resulting status
+	modelCacheState tryLabelCache ( DlCompletionTree* node );
 		/// check whether node may be (un)cached; save node if something is changed
 	modelCacheState tryCacheNode ( DlCompletionTree* node )
 	{
 		modelCacheState ret = canBeCached(node) ? reportNodeCached(node) : csFailed;
+		if ( ret == csFailed && useLabelCache() )
+			ret = tryLabelCache(node);
 		// node is cached if RET is csValid
 		CGraph.saveRareCond(node->setCached(ret == csValid));
 		return ret;
@@ -653,12 +668,30 @@ protected:	// methods
 	bool planOrProcessing ( const DLVertex& cur, DepSet& dep );
 		/// aux method for disjunction processing
 	bool processOrEntry ( void );
+		/// @return true iff the current choice of BCOR with a dep-set DEP repeats a nogood; set the clash-set then
+	bool isNogoodChoice ( const BCOr& bcOr, const DepSet& dep );
+		/// learn a nogood from the clash-set DEP if all its branching points are disjunction choices in the root
+	void learnNogood ( const DepSet& dep );
+		/// bump the activity of the disjuncts chosen in the branching points of the clash-set DEP
+	void bumpActivity ( const DepSet& dep );
 
 	// support for (qualified) number restrictions
 
 		/// create N R-neighbours of curNode with given Nominal LEVEL labelled with C
 	bool createDifferentNeighbours ( const TRole* R, BipolarPointer C, const DepSet& dep,
 											unsigned int n, CTNominalLevel level );
+		/// check whether N R-neighbours of curNode with given Nominal LEVEL could be created as a single proxy node
+	bool canUseProxy ( const TRole* R, unsigned int n, CTNominalLevel level ) const
+	{
+		// proxy copies are identical only in a tree that is not affected by their successors
+		return useAlgebraicNR() && n >= tBox.algebraicNRLimit && n > 1 && level == BlockableLevel
+			&& curNode->isBlockableNode() && !R->isDataRole() && !R->isTop() && !hasNominals()
+			&& !tBox.testHasNominals() && !tBox.isIRinQuery() && !tBox.testHasTopRole();
+	}
+		/// replace the proxy R-neighbours of curNode with the nodes they stand for unless (<= N R.C) holds arithmetically; @return true iff clash
+	bool expandProxies ( const TRole* R, BipolarPointer C, unsigned int n );
+		/// replace the proxy at the end of the EDGE from curNode with the nodes it stands for; @return true iff clash
+	bool expandProxy ( const DlCompletionTreeArc* edge );
 
 		/// check whether a node represents a functional one
 	static bool isFunctionalVertex ( const DLVertex& v ) { return ( v.Type() == dtLE && v.getNumberLE() == 1 && v.getC() == bpTOP ); }
@@ -891,6 +924,12 @@ protected:	// methods
 
 		/// restore one level (no backjumping)
 	bool straightforwardRestore ( void );
+		/// note the clash that depends on the frozen branching points (if any)
+	void checkFrozenClash ( void )
+	{
+		if ( unlikely(frozenLevel > 0) && !getClashSet().empty() && getClashSet().level() <= frozenLevel )
+			frozenClash = true;
+	}
 		/// restore if backjumping is used
 	bool backJumpedRestore ( void );
 		/// restore state based on usedBackjumping flag
@@ -917,6 +956,12 @@ public:		// blocking support
 
 		/// get access to the DAG associated with it (necessary for the blocking support)
 	const DLDag& getDAG ( void ) const { return tBox.DLHeap; }
+		/// throw EFPPTimeout if the deadline of the current query has passed
+	void checkDeadline ( void ) const { tBox.checkDeadline(); }
+		/// make the reasoner a worker of the pool with the cancellation FLAG; the progress monitor is not checked then
+	void setPoolCancelFlag ( const std::atomic<bool>* flag ) { pPoolCancelled = flag; }
+		/// @return true iff the current test should be dropped
+	bool isCancelled ( void ) const { return pPoolCancelled != nullptr ? pPoolCancelled->load() : tBox.isCancelled(); }
 
 public:
 		/// c'tor
@@ -926,12 +971,14 @@ public:
 		/// no assignment
 	DlSatTester& operator = ( const DlSatTester& ) = delete;
 		/// d'tor
-	virtual ~DlSatTester ( void ) {}
+	virtual ~DlSatTester ( void ) { delete LabelTester; }
 
 		/// prepare reasoner to a new run
 	virtual void prepareReasoner ( void );
 		/// set-up satisfiability task for given pointers and run runSat on it
 	bool runSat ( BipolarPointer p, BipolarPointer q = bpTOP );
+		/// set-up satisfiability task for the conjunction of the (non-empty) LABEL and run runSat on it
+	bool runSat ( const TLabelSatCache::Label& label );
 		/// set-up role disjointness task for given roles and run SAT test
 	bool checkDisjointRoles ( const TRole* R, const TRole* S );
 		/// set-up role irreflexivity task for R and run SAT test
@@ -1008,18 +1055,30 @@ DlSatTester :: initNewNode ( DlCompletionTree* node, const DepSet& dep, BipolarP
 inline bool
 DlSatTester :: runSat ( BipolarPointer p, BipolarPointer q )
 {
+	LOG_EVENT ( evSatStart, 0, p, q );
 	prepareReasoner();
+	// nogoods of the earlier tests with the same initial concepts hold here; query entries change their meaning
+	if ( useNogoods() && !DLHeap.isQueryEntry(p) && !DLHeap.isQueryEntry(q) )
+		Nogoods.startTest ( p, q );
+
+	bool result = false;
 
 	// use general method to init node with P and add Q then
 	if ( initNewNode ( CGraph.getRoot(), DepSet(), p ) ||
 		 addToDoEntry ( CGraph.getRoot(), ConceptWDep(q) ) )
-		return false;		// concept[s] unsatisfiable
+		checkFrozenClash();		// concept[s] unsatisfiable
+	else
+	{
+		// check satisfiability explicitly
+		TsProcTimer& timer = q == bpTOP ? satTimer : subTimer;
+		timer.Start();
+		result = runSat();
+		timer.Stop();
+	}
 
-	// check satisfiability explicitly
-	TsProcTimer& timer = q == bpTOP ? satTimer : subTimer;
-	timer.Start();
-	bool result = runSat();
-	timer.Stop();
+	// the snapshot was not enough to decide the test: prepareReasoner() would drop it
+	if ( unlikely(frozenClash) )
+		return runSat ( p, q );
 	return result;
 }
 
@@ -1031,7 +1090,10 @@ DlSatTester :: checkDisjointRoles ( const TRole* R, const TRole* S )
 	// use general method to init node...
 	DepSet dummy;
 	if ( initNewNode ( CGraph.getRoot(), dummy, bpTOP ) )
-		return true;
+	{
+		checkFrozenClash();
+		return frozenClash ? checkDisjointRoles ( R, S ) : true;
+	}
 	// ... add edges with R and S...
 	curNode = CGraph.getRoot();
 	DlCompletionTreeArc* edgeR = createOneNeighbour ( R, dummy );
@@ -1042,11 +1104,17 @@ DlSatTester :: checkDisjointRoles ( const TRole* R, const TRole* S )
 		 || setupEdge ( edgeR, dummy )
 		 || setupEdge ( edgeS, dummy )
 		 || Merge ( edgeS->getArcEnd(), edgeR->getArcEnd(), dummy ) )
-		return true;
+		checkFrozenClash();
+	else
+	{
+		// 2 roles are disjoint if current setting is unsatisfiable
+		curNode = nullptr;
+		if ( runSat() )
+			return false;
+	}
 
-	// 2 roles are disjoint if current setting is unsatisfiable
-	curNode = nullptr;
-	return !runSat();
+	// restart the test if the snapshot wasn't enough
+	return frozenClash ? checkDisjointRoles ( R, S ) : true;
 }
 
 inline bool
@@ -1057,7 +1125,10 @@ DlSatTester :: checkIrreflexivity ( const TRole* R )
 	// use general method to init node...
 	DepSet dummy;
 	if ( initNewNode ( CGraph.getRoot(), dummy, bpTOP ) )
-		return true;
+	{
+		checkFrozenClash();
+		return frozenClash ? checkIrreflexivity(R) : true;
+	}
 	// ... add an R-loop
 	curNode = CGraph.getRoot();
 	DlCompletionTreeArc* edgeR = createOneNeighbour ( R, dummy );
@@ -1065,11 +1136,17 @@ DlSatTester :: checkIrreflexivity ( const TRole* R )
 	if ( initNewNode ( edgeR->getArcEnd(), dummy, bpTOP )
 		 || setupEdge ( edgeR, dummy )
 		 || Merge ( edgeR->getArcEnd(), CGraph.getRoot(), dummy ) )
-		return true;
+		checkFrozenClash();
+	else
+	{
+		// R is irreflexive if current setting is unsatisfiable
+		curNode = nullptr;
+		if ( runSat() )
+			return false;
+	}
 
-	// R is irreflexive if current setting is unsatisfiable
-	curNode = nullptr;
-	return !runSat();
+	// restart the test if the snapshot wasn't enough
+	return frozenClash ? checkIrreflexivity(R) : true;
 }
 
 // restore implementation
@@ -1079,6 +1156,19 @@ inline bool DlSatTester :: backJumpedRestore ( void )
 	if ( getClashSet().empty () )
 		return true;
 
+	// can't backjump into the snapshot: the test has to be restarted
+	if ( unlikely ( getClashSet().level() <= frozenLevel ) )
+	{
+		frozenClash = true;
+		return true;
+	}
+
+	// remember the choices that led to the clash
+	if ( Nogoods.isActive() )
+		learnNogood(getClashSet());
+	if ( DLHeap.useActivityOrder() )
+		bumpActivity(getClashSet());
+
 	// some non-deterministic choices were done
 	restore ( getClashSet().level() );
 	return false;
@@ -1087,7 +1177,11 @@ inline bool DlSatTester :: backJumpedRestore ( void )
 inline bool DlSatTester :: straightforwardRestore ( void )
 {
 	if ( noBranchingOps() )	// no non-deterministic choices was made
-		return true;		// ... the concept is unsatisfiable
+	{
+		// ... the concept is unsatisfiable, unless the clash depends on the choices inside the snapshot
+		frozenClash = frozenLevel > 0;
+		return true;
+	}
 	else
 	{	// restoring the state
 		restore ();
@@ -1130,6 +1224,7 @@ TBox :: initCache ( const TConcept* pConcept, bool sub )
 {
 	BipolarPointer bp = sub ? inverse(pConcept->pName) : pConcept->pName;
 	const modelCacheInterface* cache = DLHeap.getCache(bp);
+	LOG_EVENT ( evSatCache, cache != nullptr, bp, 0 );
 
 	if ( cache == nullptr )
 	{
@@ -33,25 +33,81 @@ NominalReasoner :: initNominalVector ( void )
 			Nominals.push_back(*pi);
 }
 
-/// prerpare Nominal Reasoner to a new job
+/// restore the state of the nominal cloud before its 1st non-deterministic choice
 void
-NominalReasoner :: prepareReasoner ( void )
+NominalReasoner :: restoreInitialCloud ( void )
 {
-	if ( LLM.isWritable(llSRState) )
-		LL << "\nInitNominalReasoner:";
-
 	restore(1);
 
 	// check whether branching op is not a barrier...
-	if ( dynamic_cast<BCBarrier*>(bContext) == nullptr )
+	if ( bContext->getKind() != bckBarrier )
 	{	// replace it with a barrier
 		Stack.pop();
 		createBCBarrier();
 	}
 	// save the barrier (also remember the entry to be produced)
 	save();
-	// free the memory used in the pools before
-	Stack.clearPools();
+}
+
+/// freeze the complete model of the nominal cloud as a starting point for all the tests
+void
+NominalReasoner :: freezeCloud ( void )
+{
+	if ( LLM.isWritable(llSRState) )
+		LL << "FreezeNominalCloud[";
+	curNode = nullptr;
+	frozenLevel = getCurLevel();
+	createBCBarrier();
+	save();
+	// all the choices made so far are below the barrier
+	nonDetShift = frozenLevel;
+	if ( LLM.isWritable(llSRState) )
+		LL << "]";
+}
+
+/// drop the snapshot of the nominal cloud
+void
+NominalReasoner :: unfreezeCloud ( void )
+{
+	if ( LLM.isWritable(llSRState) )
+		LL << "UnfreezeNominalCloud";
+	frozenLevel = 0;
+	frozenClash = false;
+	nonDetShift = 0;
+}
+
+/// prerpare Nominal Reasoner to a new job
+void
+NominalReasoner :: prepareReasoner ( void )
+{
+	if ( LLM.isWritable(llSRState) )
+		LL << "\nInitNominalReasoner:";
+
+	// the last test can't be decided wrt the snapshot: re-run it from the initial cloud
+	if ( unlikely(frozenClash) )
+	{
+		unfreezeCloud();
+		// re-build the snapshot later unless it mostly fails
+		++nSnapshotMisses;
+		needSnapshot = nSnapshotMisses < 8 || nSnapshotTests > 2*nSnapshotMisses;
+	}
+	else if ( unlikely(needSnapshot) )
+	{
+		needSnapshot = false;
+		restoreInitialCloud();
+		resetSessionFlags();
+		if ( runSat() )
+			freezeCloud();
+	}
+
+	if ( frozenLevel > 0 )
+	{	// restart from the complete model of the nominal cloud
+		++nSnapshotTests;
+		restore(frozenLevel);
+		save();
+	}
+	else
+		restoreInitialCloud();
 
 	// clear last session information
 	resetSessionFlags();
@@ -86,6 +142,8 @@ NominalReasoner :: consistentNominalCloud ( void )
 		if ( LLM.isWritable(llSRState) )
 			LL << "]";
 	}
+	else if ( result && tBox.useNominalSnapshot )
+		freezeCloud();
 
 	if ( LLM.isWritable(llSatResult) )
 		LL << "\nThe ontology is " << (result ? "consistent" : "INCONSISTENT");
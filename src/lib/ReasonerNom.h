@@ -20,6 +20,9 @@ Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 #define REASONERNOM_H
 
 #include "Reasoner.h"
+#include "CachePrefetcher.h"
+#include "SubsumptionBatch.h"
+#include "TaskPool.h"
 
 class NominalReasoner: public DlSatTester
 {
@@ -30,12 +33,24 @@ protected:	// type definition
 protected:	// members
 		/// all nominals defined in TBox
 	SingletonVector Nominals;
+		/// number of tests started from the snapshot of the nominal cloud
+	unsigned long nSnapshotTests;
+		/// number of tests that were restarted without the snapshot
+	unsigned long nSnapshotMisses;
+		/// true iff the snapshot should be re-built before the next test
+	bool needSnapshot;
 
 protected:	// methods
 		/// prepare reasoning
 	virtual void prepareReasoner ( void );
 		/// there are nominals
 	virtual bool hasNominals ( void ) const { return true; }
+		/// restore the state of the nominal cloud before its 1st non-deterministic choice
+	void restoreInitialCloud ( void );
+		/// freeze the complete model of the nominal cloud as a starting point for all the tests
+	void freezeCloud ( void );
+		/// drop the snapshot of the nominal cloud
+	void unfreezeCloud ( void );
 
 //-----------------------------------------------------------------------------
 //--		internal nominal reasoning interface
@@ -77,6 +92,9 @@ public:
 		/// c'tor
 	NominalReasoner ( TBox& tbox )
 		: DlSatTester(tbox)
+		, nSnapshotTests(0)
+		, nSnapshotMisses(0)
+		, needSnapshot(false)
 	{
 		initNominalVector();
 	}
@@ -101,6 +119,26 @@ TBox :: initReasoner ( void )
 	{
 		nomReasoner = new NominalReasoner(*this);
 	}
+
+	// parallel features are pointless for a single thread
+	unsigned int nThreads = std::max ( nCacheThreads, nSubThreads );
+	if ( nThreads <= 1 )
+		return;
+
+	// all parallel features share the same pool of workers with private reasoners over the shared DAG
+	pTaskPool = new TaskPool(nThreads);
+	pTaskPool->setCancelHook ( [this] { return isCancelled() || getDeadline().expired(); } );
+	// the workers can't call the user's progress monitor: they watch the flag the pool sets after polling it
+	for ( unsigned int i = 0; i < nThreads; ++i )
+	{
+		PoolReasoners.push_back(new DlSatTester(*this));
+		PoolReasoners.back()->setPoolCancelFlag(&pTaskPool->getCancelFlag());
+	}
+
+	if ( nCacheThreads > 1 )
+		pPrefetcher = new CachePrefetcher(*this);
+	if ( nSubThreads > 1 )
+		pSubBatch = new SubsumptionBatch(*this);
 }
 
 #endif
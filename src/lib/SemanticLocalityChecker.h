@@ -19,8 +19,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef SEMLOCCHECKER_H
 #define SEMLOCCHECKER_H
 
-#include "LocalityChecker.h"
+#include <unordered_map>
+
 #include "Kernel.h"
+#include "SyntacticLocalityChecker.h"
 
 /// semantic locality checker for DL axioms
 class SemanticLocalityChecker: public LocalityChecker
@@ -32,8 +34,38 @@ protected:	// members
 	TExpressionManager* pEM;
 		/// map between axioms and concept expressions
 	std::map<const TDLAxiom*, const TDLConceptExpression*> ExprMap;
+		/// syntactic checker wrt the same signature; syntactic locality implies the semantic one
+	SyntacticLocalityChecker SynChecker;
+		/// results of the checks (indexed by an axiom id) wrt the part of the axiom signature in the signature
+	std::vector<std::unordered_map<uint64_t, bool>> Results;
+		/// whether the cheap checks are used before the reasoner
+	bool useFastChecks;
+		/// number of axioms found local syntactically
+	unsigned long long nSyntactic;
+		/// number of axioms answered from the results
+	unsigned long long nCached;
+		/// number of axioms checked by the reasoner
+	unsigned long long nReasoned;
 
 protected:	// methods
+		/// @return the key of the AXIOM wrt the current signature, built from the entities of the axiom in it and the locality; @return 0 if there are too many entities
+	uint64_t getKey ( const TDLAxiom* axiom ) const
+	{
+		const TSignature& aSig = const_cast<TDLAxiom*>(axiom)->getSignature();
+		if ( aSig.size() > 61 )
+			return 0;
+		uint64_t key = 1;
+		for ( TSignature::iterator p = aSig.begin(), p_end = aSig.end(); p != p_end; ++p )
+			key = (key << 1) | ( nc(*p) ? 0 : 1 );
+		return (key << 2) | ( topCLocal() ? 2 : 0 ) | ( topRLocal() ? 1 : 0 );
+	}
+		/// @return locality of an AXIOM checked by the reasoner
+	bool reason ( const TDLAxiom* axiom )
+	{
+		++nReasoned;
+		axiom->accept(*this);
+		return isLocal;
+	}
 		/// @return expression necessary to build query for a given type of an axiom; @return NULL if none necessary
 	const TDLConceptExpression* getExpr ( const TDLAxiom* axiom )
 	{
@@ -59,7 +91,13 @@ protected:	// methods
 
 public:		// interface
 		/// init c'tor
-	SemanticLocalityChecker ( const TSignature* sig ) : LocalityChecker(sig)
+	SemanticLocalityChecker ( const TSignature* sig )
+		: LocalityChecker(sig)
+		, SynChecker(sig)
+		, useFastChecks(true)
+		, nSyntactic(0)
+		, nCached(0)
+		, nReasoned(0)
 	{
 		pEM = Kernel.getExpressionManager();
 		// for tests we will need TB names to be from the OWL 2 namespace
@@ -77,6 +115,7 @@ public:		// interface
 	{
 		TSignature s;
 		ExprMap.clear();
+		Results.clear();
 		for ( AxiomVec::const_iterator q = Axioms.begin(), q_end = Axioms.end(); q != q_end; ++q )
 		{
 			ExprMap[*q] = getExpr(*q);
@@ -91,10 +130,48 @@ public:		// interface
 		Kernel.realiseKB();
 		// after TBox appears there, set signature to translate
 		Kernel.setSignature(getSignature());
-		// disallow usage of the expression cache as same expressions will lead to different translations
-		Kernel.setIgnoreExprCache(true);
+		// the kernel drops the cached queries when the signature changes, so the cache is only ignored in a plain mode
+		Kernel.setIgnoreExprCache(!useFastChecks);
+		// keep the query concepts of the current signature in the DAG
+		if ( useFastChecks )
+			Kernel.setQueryCacheSize(256);
 	}
 
+		/// @return true iff an AXIOM is local wrt signature
+	virtual bool local ( const TDLAxiom* axiom )
+	{
+		if ( !useFastChecks )
+			return reason(axiom);
+		if ( SynChecker.local(axiom) )
+		{
+			++nSyntactic;
+			return true;
+		}
+		// the axiom is checked in a KB with declarations only, so the result depends only on the entities of the axiom in the signature
+		uint64_t key = getKey(axiom);
+		if ( key == 0 )
+			return reason(axiom);
+		if ( axiom->getId() >= Results.size() )
+			Results.resize(axiom->getId()+1);
+		std::unordered_map<uint64_t, bool>& results = Results[axiom->getId()];
+		auto p = results.find(key);
+		if ( p != results.end() )
+		{
+			++nCached;
+			return p->second;
+		}
+		return results[key] = reason(axiom);
+	}
+
+		/// choose whether the syntactic check and the stored results are used before the reasoner; set it before preprocessOntology()
+	void setUseFastChecks ( bool value ) { useFastChecks = value; }
+		/// @return number of axioms found local syntactically
+	unsigned long long getNSyntactic ( void ) const { return nSyntactic; }
+		/// @return number of axioms answered from the stored results
+	unsigned long long getNCached ( void ) const { return nCached; }
+		/// @return number of axioms checked by the reasoner
+	unsigned long long getNReasoned ( void ) const { return nReasoned; }
+
 public:		// visitor interface
 	virtual void visit ( const TDLAxiomDeclaration& ) { isLocal = true; }
 
@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tDLAxiom.h"
 #include "tSignature.h"
 #include "LocalityChecker.h"
+#include "CompiledLocality.h"
 
 class SigIndex
 {
@@ -42,6 +43,10 @@ protected:	// members
 	EntityAxiomMap Base;
 		/// locality checker
 	LocalityChecker* Checker;
+		/// compiled syntactic locality of the registered axioms
+	CompiledLocality Compiled;
+		/// true iff the locality of the registered axioms should be compiled
+	bool useCompiled;
 		/// sets of axioms non-local wrt the empty signature
 	AxiomVec NonLocal[2];
 		/// empty signature to test the non-locality
@@ -84,6 +89,8 @@ protected:	// methods
 		// check whether the axiom is non-local
 		checkNonLocal ( ax, /*top=*/false );
 		checkNonLocal ( ax, /*top=*/true );
+		if ( useCompiled )
+			Compiled.registerAx(ax);
 		++nRegistered;
 	}
 		/// unregister an axiom AX
@@ -94,12 +101,19 @@ protected:	// methods
 		// remove from the non-locality
 		remove ( NonLocal[false], ax );
 		remove ( NonLocal[true], ax );
+		if ( useCompiled )
+			Compiled.unregisterAx(ax);
 		++nUnregistered;
 	}
 
 public:		// interface
-		/// empty c'tor
-	SigIndex ( LocalityChecker* checker ) : Checker(checker), nRegistered(0), nUnregistered(0) {}
+		/// init c'tor; compile the syntactic locality of the axioms if COMPILE is true
+	SigIndex ( LocalityChecker* checker, bool compile = false )
+		: Checker(checker)
+		, useCompiled(compile)
+		, nRegistered(0)
+		, nUnregistered(0)
+		{}
 		/// empty d'tor
 	~SigIndex ( void ) {}
 
@@ -125,14 +139,26 @@ public:		// interface
 		Base.clear();
 		NonLocal[0].clear();
 		NonLocal[1].clear();
+		Compiled.clear();
 	}
 
 	// get the set by the index
 
 		/// given an entity, return a set of all axioms that tontain this entity in a signature
 	const AxiomVec& getAxioms ( const TNamedEntity* entity ) { return Base[entity]; }
+		/// RO version of the above: does not change the index, so could be used concurrently
+	const AxiomVec& getAxioms ( const TNamedEntity* entity ) const
+	{
+		static const AxiomVec empty;
+		EntityAxiomMap::const_iterator p = Base.find(entity);
+		return p == Base.end() ? empty : p->second;
+	}
 		/// get the non-local axioms with top-locality value TOP
 	const AxiomVec& getNonLocal ( bool top ) const { return NonLocal[!top]; }
+		/// get the compiled locality of the axioms; @return NULL if the locality is not compiled
+	CompiledLocality* getCompiledLocality ( void ) { return useCompiled ? &Compiled : nullptr; }
+		/// RO access to the compiled locality of the axioms; @return NULL if the locality is not compiled
+	const CompiledLocality* getCompiledLocality ( void ) const { return useCompiled ? &Compiled : nullptr; }
 
 	// access to statistics
 
@@ -0,0 +1,121 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SLABALLOCATOR_H
+#define SLABALLOCATOR_H
+
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "DeletelessAllocator.h"
+
+/**
+ * Class for the allocator that creates objects one after another in large
+ * contiguous slabs. Objects are never deleted separately: all of them are
+ * destroyed together with the allocator.
+ */
+template<class T>
+class SlabAllocator
+{
+protected:	// types
+		/// contiguous chunk of objects
+	struct Slab
+	{
+			/// memory for the objects
+		T* Data;
+			/// number of created objects
+		size_t Used;
+			/// max number of objects
+		size_t Size;
+	}; // Slab
+
+protected:	// members
+		/// all the slabs; the last one is the current
+	std::vector<Slab> Slabs;
+		/// size of the first slab
+	size_t InitSize;
+
+protected:	// methods
+		/// add new slab able to keep N objects
+	void addSlab ( size_t n )
+	{
+		Slab slab;
+		slab.Data = static_cast<T*>(::operator new(n*sizeof(T)));
+		slab.Used = 0;
+		slab.Size = n;
+		Slabs.push_back(slab);
+	}
+
+public:		// interface
+		/// c'tor: the 1st slab will keep SIZE objects; the next ones are twice as big as the previous
+	explicit SlabAllocator ( size_t size = 64 ) : InitSize(size > 0 ? size : 1) {}
+		/// no copy c'tor
+	SlabAllocator ( const SlabAllocator& ) = delete;
+		/// no assignment
+	SlabAllocator& operator= ( const SlabAllocator& ) = delete;
+		/// d'tor: destroy all the objects
+	~SlabAllocator ( void )
+	{
+		for ( auto& slab: Slabs )
+		{
+			for ( size_t i = 0; i < slab.Used; ++i )
+				slab.Data[i].~T();
+			::operator delete(slab.Data);
+		}
+	}
+
+		/// create new object with given ARGS next to the previously created one
+	template<typename... Args>
+	T* create ( Args&&... args )
+	{
+		if ( Slabs.empty() || Slabs.back().Used == Slabs.back().Size )
+			addSlab ( Slabs.empty() ? InitSize : 2*Slabs.back().Size );
+		Slab& slab = Slabs.back();
+		T* ret = new (slab.Data+slab.Used) T(std::forward<Args>(args)...);
+		++slab.Used;
+		return ret;
+	}
+}; // SlabAllocator
+
+/**
+ * Deleteless allocator which objects are kept in contiguous slabs.
+ */
+template<class T>
+class SlabDeletelessAllocator: public DeletelessAllocator<T>
+{
+protected:	// members
+		/// real owner of all the objects
+	SlabAllocator<T> Slabs;
+
+protected:	// methods
+		/// create new object in a slab
+	virtual T* createNew ( void ) { return Slabs.create(); }
+
+public:		// interface
+		/// c'tor: do nothing
+	SlabDeletelessAllocator ( void ) {}
+		/// d'tor: all the objects will be deleted by Slabs
+	virtual ~SlabDeletelessAllocator ( void )
+	{
+		for ( auto& p: this->Base )
+			p = nullptr;
+	}
+}; // SlabDeletelessAllocator
+
+#endif
@@ -0,0 +1,71 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "SubsumptionBatch.h"
+#include "Reasoner.h"
+#include "TaskPool.h"
+
+/// run the TASK using the reasoner WORKER
+void
+SubsumptionBatch :: runTask ( DlSatTester* worker, Task& task )
+{
+	// timeouts and cancellation will be re-discovered by the main reasoner if necessary
+	worker->setBlockingMethod ( task.hasInverse, task.hasQCR );
+	bool sat = worker->runSat ( task.p, inverse(task.q) );
+	// a cancelled test is not a subsumption: leave it undone
+	if ( worker->isCancelled() )
+		return;
+	task.result = !sat;
+	task.done = true;
+}
+
+/// run all the scheduled tests; the call returns when all of them are done
+void
+SubsumptionBatch :: run ( void )
+{
+	// NOTE: the DAG is read-only while the tasks are running
+	TaskPool& pool = tBox.getTaskPool();
+	for ( auto& task: Tasks )
+	{
+		Task* t = &task;
+		pool.submit ( [this,t] ( unsigned int i ) { runTask ( tBox.getPoolReasoner(i), *t ); } );
+	}
+	// the results of a cancelled run are dropped altogether: the main reasoner re-discovers the cancellation
+	if ( !pool.wait() )
+		for ( auto& task: Tasks )
+			task.done = false;
+
+	nTests += Tasks.size();
+}
+
+//-----------------------------------------------------------------------------
+//--		implemenation of parallel subsumption-related parts of TBox
+//-----------------------------------------------------------------------------
+
+/// schedule the test P [= Q for the parallel run; @return false iff the test can't be made in parallel
+bool
+TBox :: scheduleSub ( const TConcept* p, const TConcept* q, size_t& index )
+{
+	prepareFeatures ( p, q );
+	// nominal reasoner changes the individuals, so it can't be used in parallel
+	bool parallel = !curFeature->hasSingletons();
+	if ( parallel )
+		index = pSubBatch->add ( p->resolveId(), q->resolveId(), isIRinQuery(), isNRinQuery() );
+	clearFeatures();
+	return parallel;
+}
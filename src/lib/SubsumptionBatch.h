@@ -0,0 +1,97 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SUBSUMPTIONBATCH_H
+#define SUBSUMPTIONBATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "BiPointer.h"
+
+class TBox;
+class DlSatTester;
+
+/// run a batch of independent subsumption tests in parallel, using the TBox's pool of workers
+class SubsumptionBatch
+{
+protected:	// types
+		/// single subsumption test P [= Q
+	struct Task
+	{
+			/// DAG entries of the tested concepts
+		BipolarPointer p, q;
+			/// blocking method: whether inverse roles are present
+		bool hasInverse;
+			/// blocking method: whether number restrictions are present
+		bool hasQCR;
+			/// true iff the test was finished
+		bool done;
+			/// the result of the test
+		bool result;
+			/// init c'tor
+		Task ( BipolarPointer P, BipolarPointer Q, bool inv, bool qcr )
+			: p(P), q(Q), hasInverse(inv), hasQCR(qcr), done(false), result(false) {}
+	}; // Task
+		/// vector of tasks
+	typedef std::vector<Task> TaskVector;
+
+protected:	// members
+		/// host TBox
+	TBox& tBox;
+		/// tasks of the current batch
+	TaskVector Tasks;
+		/// number of tests made in parallel
+	unsigned long nTests;
+
+protected:	// methods
+		/// run the TASK using the reasoner WORKER
+	static void runTask ( DlSatTester* worker, Task& task );
+
+public:		// interface
+		/// init c'tor: use the pool of TBOX
+	explicit SubsumptionBatch ( TBox& tbox ) : tBox(tbox), nTests(0) {}
+		/// no copy c'tor
+	SubsumptionBatch ( const SubsumptionBatch& ) = delete;
+		/// no assignment
+	SubsumptionBatch& operator = ( const SubsumptionBatch& ) = delete;
+
+		/// schedule the test P [= Q with a given blocking method; @return the index of the test
+	size_t add ( BipolarPointer p, BipolarPointer q, bool hasInverse, bool hasQCR )
+	{
+		Tasks.push_back(Task(p,q,hasInverse,hasQCR));
+		return Tasks.size()-1;
+	}
+		/// @return true iff there is something to do in parallel
+	bool worthRunning ( void ) const { return Tasks.size() > 1; }
+		/// run all the scheduled tests; the call returns when all of them are done
+	void run ( void );
+		/// @return true iff the I-th test was finished; its result is in RESULT then
+	bool getResult ( size_t i, bool& result ) const
+	{
+		result = Tasks[i].result;
+		return Tasks[i].done;
+	}
+		/// drop all the scheduled tasks
+	void clear ( void ) { Tasks.clear(); }
+
+		/// @return number of tests made in parallel
+	unsigned long getNumTests ( void ) const { return nTests; }
+}; // SubsumptionBatch
+
+#endif
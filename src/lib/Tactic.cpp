@@ -58,7 +58,12 @@ bool DlSatTester :: commonTactic ( void )
 
 	// apply tactic only if Node is not an i-blocked
 	if ( !isIBlocked() )
+	{
+		LOG_EVENT ( evRule, DLHeap.getTag(curConcept.bp()), curNode->getId(), curConcept.bp() );
 		ret = commonTacticBody ( DLHeap[curConcept] );
+		if ( ret )
+			LOG_EVENT ( evClash, getClashSet().level(), curNode->getId(), curConcept.bp() );
+	}
 
 	if ( LLM.isWritable(llGTA) )
 		logFinishEntry(ret);
@@ -296,13 +301,13 @@ bool DlSatTester :: commonTacticBodyOr ( const DLVertex& cur )	// for C \or D co
 		if ( OrConceptsToTest.size() == 1 )
 		{
 			BipolarPointer C = OrConceptsToTest.back();
-			return insertToDoEntry ( curNode, ConceptWDep(C,dep), DLHeap[C].Type(), "bcp" );
+			return insertToDoEntry ( curNode, ConceptWDep(C,dep), DLHeap.getTag(C), "bcp" );
 		}
 
 		// more than one alternative: use branching context
 		createBCOr();
 		bContext->branchDep = dep;
-		static_cast<BCOr*>(bContext)->applicableOrEntries.swap(OrConceptsToTest);
+		bContext->getOr().applicableOrEntries.swap(OrConceptsToTest);
 	}
 
 	// now it is OR case with 1 or more applicable concepts
@@ -320,7 +325,7 @@ bool DlSatTester :: planOrProcessing ( const DLVertex& cur, DepSet& dep )
 	for ( DLVertex::const_iterator q = cur.begin(), q_end = cur.end(); q < q_end; ++q )
 	{
 		BipolarPointer C = inverse(*q);
-		switch ( tryAddConcept ( lab.getLabel(DLHeap[C].Type()), C, dummy ) )
+		switch ( tryAddConcept ( lab.getLabel(DLHeap.getTag(C)), C, dummy ) )
 		{
 		case acrClash:	// clash found -- OK
 			dep.add(getClashSet());
@@ -337,13 +342,17 @@ bool DlSatTester :: planOrProcessing ( const DLVertex& cur, DepSet& dep )
 		}
 	}
 
+	// order the disjuncts wrt the recent clashes they caused
+	if ( DLHeap.useActivityOrder() && OrConceptsToTest.size() > 1 )
+		DLHeap.sortByActivity ( OrConceptsToTest, Activity );
+
 	return false;
 }
 
 bool DlSatTester :: processOrEntry ( void )
 {
 	// save the context here as after save() it would be lost
-	const BCOr* bcOr = static_cast<BCOr*>(bContext);
+	const BCOr* bcOr = &bContext->getOr();
 	BCOr::or_iterator p = bcOr->orBeg(), p_end = bcOr->orCur();
 	BipolarPointer C = *p_end;
 	const char* reason = nullptr;
@@ -367,6 +376,13 @@ bool DlSatTester :: processOrEntry ( void )
 		incStat(nOrBrCalls);
 	}
 
+	// the choice is known to fail
+	if ( Nogoods.isActive() && curNode == CGraph.getRoot() && isNogoodChoice ( *bcOr, dep ) )
+	{
+		incStat(nNogoodPrunes);
+		return true;
+	}
+
 	// if semantic branching is in use -- add previous entries to the label
 	if ( useSemanticBranching() )
 		for ( ; p < p_end; ++p )
@@ -378,10 +394,54 @@ bool DlSatTester :: processOrEntry ( void )
 #	ifdef RKG_USE_DYNAMIC_BACKJUMPING
 		addToDoEntry ( curNode, ConceptWDep(C,dep), reason );
 #	else
-		insertToDoEntry ( curNode, ConceptWDep(C,dep), DLHeap[C].Type(), reason );
+		insertToDoEntry ( curNode, ConceptWDep(C,dep), DLHeap.getTag(C), reason );
 #	endif
 }
 
+bool DlSatTester :: isNogoodChoice ( const BCOr& bcOr, const DepSet& dep )
+{
+	// concepts that the choice adds to the label
+	NogoodConcepts.clear();
+	NogoodConcepts.push_back(*bcOr.orCur());
+	if ( useSemanticBranching() )
+		for ( BCOr::or_iterator p = bcOr.orBeg(), p_end = bcOr.orCur(); p < p_end; ++p )
+			NogoodConcepts.push_back(inverse(*p));
+
+	const CGLabel& lab = curNode->label();
+	for ( const auto& C: NogoodConcepts )
+		for ( const auto& i: Nogoods.find(C) )
+		{
+			const TNogoodStore::Nogood& nogood = Nogoods[i];
+			if ( !Nogoods.applicable(nogood) )
+				continue;
+			// the rest of the nogood should be in the label already
+			DepSet clashDep(dep);
+			bool found = true;
+			for ( const auto& D: nogood.Concepts )
+			{
+				if ( std::find ( NogoodConcepts.begin(), NogoodConcepts.end(), D ) != NogoodConcepts.end() )
+					continue;
+				const CWDArray& label = lab.getLabel(DLHeap.getTag(D));
+				CWDArray::const_iterator q = std::find ( label.begin(), label.end(), D );
+				if ( q == label.end() )
+				{
+					found = false;
+					break;
+				}
+				clashDep.add(q->getDep());
+			}
+			if ( found )
+			{
+				if ( LLM.isWritable(llGTA) )
+					LL << " ng(" << i << ")";
+				setClashSet(clashDep);
+				return true;
+			}
+		}
+
+	return false;
+}
+
 //-------------------------------------------------------------------------------
 //	ALL processing
 //-------------------------------------------------------------------------------
@@ -490,7 +550,7 @@ bool DlSatTester :: commonTacticBodySome ( const DLVertex& cur )	// for ER.C con
 	if ( isSomeExists ( R, C ) )
 		return false;
 	// try to check the case (some R (or C D)), where C is in the label of an R-neighbour
-	if ( isNegative(C) && DLHeap[C].Type() == dtAnd )
+	if ( isNegative(C) && DLHeap.getTag(C) == dtAnd )
 		for ( const auto& arg: DLHeap[C] )
 			if ( isSomeExists ( R, inverse(arg) ) )
 				return false;
@@ -558,7 +618,7 @@ bool DlSatTester :: commonTacticBodySome ( const DLVertex& cur )	// for ER.C con
 		const DlCompletionTreeArc* functionalArc = nullptr;
 
 		// check if we have an (R)-successor or (R-)-predecessor
-		for ( const auto& edge: *curNode )
+		for ( const auto& edge: curNode->neighbours(RF) )
 			if ( edge->isNeighbour (RF) )
 			{
 				functionalArc = edge;
@@ -744,7 +804,7 @@ DlSatTester :: applyAllGeneratingRules ( DlCompletionTree* node )
 		if ( isPositive(p->bp()) )
 			continue;
 
-		switch ( DLHeap[*p].Type() )
+		switch ( DLHeap.getTag(*p) )
 		{
 		case dtForall:
 		case dtLE:
@@ -810,10 +870,15 @@ bool DlSatTester :: applyUniversalNR ( DlCompletionTree* Node,
 		if ( isNegative(p->bp()) )
 			continue;
 
+		DagTag tag = DLHeap.getTag(*p);
+		// only role-related vertices are interesting here
+		if ( tag != dtIrr && tag != dtForall && tag != dtLE )
+			continue;
+
 		const DLVertex& v = DLHeap[*p];
 		const TRole* vR = v.getRole();
 
-		switch ( v.Type() )
+		switch ( tag )
 		{
 		case dtIrr:
 			if ( redoFlags & redoIrr )
@@ -901,6 +966,10 @@ bool DlSatTester :: commonTacticBodyFunc ( const DLVertex& cur )	// for <=1 R co
 	if ( isQuickClashLE(cur) )
 		return true;
 
+	// proxies stand for several different nodes
+	if ( unlikely(useAlgebraicNR()) )
+		switchResult ( expandProxies ( R, bpTOP, 1 ) );
+
 	// locate all R-neighbours of curNode
 	DepSet dummy;	// not used
 	findNeighbours ( R, bpTOP, dummy );
@@ -942,12 +1011,17 @@ bool DlSatTester :: commonTacticBodyLE ( const DLVertex& cur )	// for <=nR.C con
 
 	if ( !isFirstBranchCall() )
 	{
-		if ( dynamic_cast<BCNN*>(bContext) != nullptr )
+		switch ( bContext->getKind() )
+		{
+		case bckNN:
 			return commonTacticBodyNN(cur);	// after application <=-rule would be checked again
-		if ( dynamic_cast<BCLE<DlCompletionTreeArc>*>(bContext) != nullptr )
+		case bckLE:
 			needInit = false;	// clash in LE-rule: skip the initial checks
-		else	// the only possible case is choose-rule; in this case just continue
-			fpp_assert ( dynamic_cast<BCChoose*>(bContext) != nullptr );
+			break;
+		default:	// the only possible case is choose-rule; in this case just continue
+			fpp_assert ( bContext->getKind() == bckChoose );
+			break;
+		}
 	}
 	else	// if we are here that it IS first LE call
 		if ( isQuickClashLE(cur) )
@@ -956,6 +1030,10 @@ bool DlSatTester :: commonTacticBodyLE ( const DLVertex& cur )	// for <=nR.C con
 	// initial phase: choose-rule, NN-rule
 	if ( needInit )
 	{
+		// copies of a proxy might be labelled differently or merged, so use the real nodes then
+		if ( unlikely(useAlgebraicNR()) )
+			switchResult ( expandProxies ( R, C, cur.getNumberLE() ) );
+
 		// check if we have Qualified NR
 		if ( C != bpTOP )
 			switchResult ( commonTacticBodyChoose ( R, C ) );
@@ -968,11 +1046,14 @@ bool DlSatTester :: commonTacticBodyLE ( const DLVertex& cur )	// for <=nR.C con
 	// we need to repeat merge until there will be necessary amount of edges
 	while (1)
 	{
+		// there might be many merge options, so check the deadline for each of them
+		checkDeadline();
+
 		if ( isFirstBranchCall() )
 			if ( initLEProcessing(cur) )
 				return false;
 
-		BCLE<DlCompletionTreeArc>* bcLE = static_cast<BCLE<DlCompletionTreeArc>*>(bContext);
+		BCLE<DlCompletionTreeArc>* bcLE = &bContext->getLE();
 
 		if ( bcLE->noMoreLEOptions() )
 		{	// set global clashset to cumulative one from previous branch failures
@@ -999,7 +1080,7 @@ bool DlSatTester :: commonTacticBodyLE ( const DLVertex& cur )	// for <=nR.C con
 			else	// QCR: update dep-set wrt C
 			{
 				// here we know that C is in both labels; set a proper clash-set
-				bool isComplex = CGLabel::isComplexConcept(DLHeap[C].Type());
+				bool isComplex = CGLabel::isComplexConcept(DLHeap.getTag(C));
 				bool test {false};
 
 				// here dep contains the clash-set
@@ -1048,7 +1129,7 @@ DlSatTester :: initLEProcessing ( const DLVertex& cur )
 	bContext->branchDep += dep;
 
 	// setup BCLE
-	BCLE<DlCompletionTreeArc>* bcLE = static_cast<BCLE<DlCompletionTreeArc>*>(bContext);
+	BCLE<DlCompletionTreeArc>* bcLE = &bContext->getLE();
 
 	bcLE->ItemsToMerge.swap(EdgesToMerge);
 	bcLE->resetMCI();
@@ -1130,10 +1211,10 @@ DlSatTester :: processTopRoleLE ( const DLVertex& cur )	// for <=nR.C concepts
 
 	if ( !isFirstBranchCall() )
 	{
-		if ( dynamic_cast<BCLE<DlCompletionTree>*>(bContext) != nullptr )
+		if ( bContext->getKind() == bckTopLE )
 			needInit = false;	// clash in LE-rule: skip the initial checks
 		else	// the only possible case is choose-rule; in this case just continue
-			fpp_assert ( dynamic_cast<BCChoose*>(bContext) != nullptr );
+			fpp_assert ( bContext->getKind() == bckChoose );
 	}
 	else	// if we are here that it IS first LE call
 		if ( isQuickClashLE(cur) )
@@ -1154,7 +1235,7 @@ DlSatTester :: processTopRoleLE ( const DLVertex& cur )	// for <=nR.C concepts
 			if ( initTopLEProcessing(cur) )
 				return false;
 
-		BCLE<DlCompletionTree>* bcLE = static_cast<BCLE<DlCompletionTree>*>(bContext);
+		BCLE<DlCompletionTree>* bcLE = &bContext->getTopLE();
 
 		if ( bcLE->noMoreLEOptions() )
 		{	// set global clashset to cumulative one from previous branch failures
@@ -1176,7 +1257,7 @@ DlSatTester :: processTopRoleLE ( const DLVertex& cur )	// for <=nR.C concepts
 			else	// QCR: update dep-set wrt C
 			{
 				// here we know that C is in both labels; set a proper clash-set
-				bool isComplex = CGLabel::isComplexConcept(DLHeap[C].Type());
+				bool isComplex = CGLabel::isComplexConcept(DLHeap.getTag(C));
 				bool test {false};
 
 				// here dep contains the clash-set
@@ -1238,7 +1319,7 @@ DlSatTester :: initTopLEProcessing ( const DLVertex& cur )
 	bContext->branchDep += dep;
 
 	// setup BCLE
-	BCLE<DlCompletionTree>* bcLE = static_cast<BCLE<DlCompletionTree>*>(bContext);
+	BCLE<DlCompletionTree>* bcLE = &bContext->getTopLE();
 
 	bcLE->ItemsToMerge.swap(NodesToMerge);
 	bcLE->resetMCI();
@@ -1254,13 +1335,22 @@ DlSatTester :: initTopLEProcessing ( const DLVertex& cur )
 bool DlSatTester :: createDifferentNeighbours ( const TRole* R, BipolarPointer C, const DepSet& dep,
 													   unsigned int n, CTNominalLevel level )
 {
+	// a single proxy might stand for all the nodes
+	bool proxy = canUseProxy ( R, n, level );
+	if ( proxy )
+	{
+		incStat(nGeProxyCalls);
+	}
+
 	// create N new edges with the same IR
 	DlCompletionTreeArc* pA = nullptr;
 	CGraph.initIR();
-	for ( unsigned int i = 0; i < n; ++i )
+	for ( unsigned int i = 0; i < ( proxy ? 1 : n ); ++i )
 	{
 		pA = createOneNeighbour ( R, dep, level );
 		DlCompletionTree* child = pA->getArcEnd();
+		if ( proxy )
+			child->setMultiplicity(n);
 
 		// make CHILD different from other created nodes
 		// don't care about return value as clash can't occur
@@ -1272,6 +1362,71 @@ bool DlSatTester :: createDifferentNeighbours ( const TRole* R, BipolarPointer C
 	}
 	CGraph.finiIR();
 
+	// re-apply all <= NR in curNode; do it only once for all created nodes; no need for Irr
+	return applyUniversalNR ( curNode, pA, dep, redoFunc|redoAtMost );
+}
+
+bool
+DlSatTester :: expandProxies ( const TRole* R, BipolarPointer C, unsigned int n )
+{
+	// count R-neighbours labelled with C, each proxy as many times as it stands for
+	EdgeVector proxies;
+	unsigned int nNeighbours = 0;
+	bool needExpand = false;
+	for ( const auto& edge: curNode->neighbours(R) )
+		if ( edge->isNeighbour(R) )
+		{
+			const DlCompletionTree* node = edge->getArcEnd();
+			if ( C != bpTOP && !node->isLabelledBy(C) )
+			{
+				// choose-rule could label copies of a proxy differently
+				if ( node->isProxy() && !node->isLabelledBy(inverse(C)) )
+				{
+					proxies.push_back(edge);
+					needExpand = true;
+				}
+				continue;
+			}
+			nNeighbours += node->getMultiplicity();
+			if ( node->isProxy() )
+				proxies.push_back(edge);
+		}
+
+	// nothing to do if there are no proxies or the restriction holds for them
+	if ( proxies.empty() || ( !needExpand && nNeighbours <= n ) )
+		return false;
+
+	// a proxy could be found several times; it is expanded only once
+	for ( auto& edge: proxies )
+		switchResult ( expandProxy(edge) );
+	return false;
+}
+
+bool
+DlSatTester :: expandProxy ( const DlCompletionTreeArc* edge )
+{
+	DlCompletionTree* proxy = edge->getArcEnd();
+	unsigned int n = proxy->getMultiplicity();
+	if ( n < 2 )
+		return false;
+
+	incStat(nProxyExpansions);
+	DepSet dep(edge->getDep());
+	CGraph.saveRareCond(proxy->clearMultiplicity());
+
+	// create the rest of the nodes; they are in the same IR as the proxy
+	DlCompletionTreeArc* pA = nullptr;
+	for ( unsigned int i = 1; i < n; ++i )
+	{
+		pA = createOneNeighbour ( edge->getRole(), dep );
+		DlCompletionTree* child = pA->getArcEnd();
+		CGraph.copyIR ( child, proxy, dep );
+
+		// add necessary new node labels and setup new edge
+		switchResult ( initNewNode ( child, dep, proxy->getInit() ) );
+		switchResult ( setupEdge ( pA, dep, redoForall ) );
+	}
+
 	// re-apply all <= NR in curNode; do it only once for all created nodes; no need for Irr
 	return applyUniversalNR ( curNode, pA, dep, redoFunc|redoAtMost );
 }
@@ -1349,12 +1504,12 @@ bool DlSatTester :: mergeLabels ( const CGLabel& from, DlCompletionTree* to, con
 		if ( findConcept ( sc, *p ) )
 			CGraph.saveRareCond ( sc.updateDepSet ( p->bp(), p->getDep() ) );
 		else
-			switchResult ( insertToDoEntry ( to, ConceptWDep(*p,dep), DLHeap[*p].Type(), "M" ) );
+			switchResult ( insertToDoEntry ( to, ConceptWDep(*p,dep), DLHeap.getTag(*p), "M" ) );
 	for ( p = from.begin_cc(), p_end = from.end_cc(); p < p_end; ++p )
 		if ( findConcept ( cc, *p ) )
 			CGraph.saveRareCond ( cc.updateDepSet ( p->bp(), p->getDep() ) );
 		else
-			switchResult ( insertToDoEntry ( to, ConceptWDep(*p,dep), DLHeap[*p].Type(), "M" ) );
+			switchResult ( insertToDoEntry ( to, ConceptWDep(*p,dep), DLHeap.getTag(*p), "M" ) );
 
 	return false;
 }
@@ -1447,9 +1602,9 @@ void
 DlSatTester :: findNeighbours ( const TRole* Role, BipolarPointer C, DepSet& Dep )
 {
 	EdgesToMerge.clear();
-	bool isComplex = CGLabel::isComplexConcept(DLHeap[C].Type());
+	bool isComplex = CGLabel::isComplexConcept(DLHeap.getTag(C));
 
-	for ( auto& edge: *curNode )
+	for ( const auto& edge: curNode->neighbours(Role) )
 		if ( edge->isNeighbour(Role)
 			 && isNewEdge ( edge->getArcEnd(), EdgesToMerge.begin(), EdgesToMerge.end() )
 			 && findChooseRuleConcept ( edge->getArcEnd()->label().getLabel(isComplex), C, Dep ) )
@@ -1469,7 +1624,7 @@ void
 DlSatTester :: findCLabelledNodes ( BipolarPointer C, DepSet& Dep )
 {
 	NodesToMerge.clear();
-	bool isComplex = CGLabel::isComplexConcept(DLHeap[C].Type());
+	bool isComplex = CGLabel::isComplexConcept(DLHeap.getTag(C));
 
 	// FIXME!! do we need this for d-blocked nodes?
 	for ( auto& node: CGraph )
@@ -1488,7 +1643,7 @@ DlSatTester :: findCLabelledNodes ( BipolarPointer C, DepSet& Dep )
 bool DlSatTester :: commonTacticBodyChoose ( const TRole* R, BipolarPointer C )
 {
 	// apply choose-rule for every R-neighbour
-	for ( auto& edge: *curNode )
+	for ( const auto& edge: curNode->neighbours(R) )
 		if ( edge->isNeighbour(R) )
 			switchResult ( applyChooseRule ( edge->getArcEnd(), C ) );
 
@@ -1546,7 +1701,7 @@ bool DlSatTester :: commonTacticBodyNN ( const DLVertex& cur )	// NN-rule
 	if ( isFirstBranchCall() )
 		createBCNN();
 
-	const BCNN* bcNN = static_cast<BCNN*>(bContext);
+	const BCNN* bcNN = &bContext->getNN();
 
 	// check whether we did all possible tries
 	if ( bcNN->noMoreNNOptions(cur.getNumberLE()) )
@@ -0,0 +1,217 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <chrono>
+
+#include "TaskPool.h"
+#include "eFPPTimeout.h"
+
+/// pool the current thread works for (if any)
+static thread_local const TaskPool* curPool = nullptr;
+/// index of the worker in the current thread
+static thread_local unsigned int curWorker = 0;
+
+TaskPool :: TaskPool ( unsigned int n )
+	: nQueued(0)
+	, nPending(0)
+	, nextQueue(0)
+	, Cancelled(false)
+	, Stop(false)
+	, nStolen(0)
+	, nTimeouts(0)
+{
+	if ( n == 0 )
+		n = 1;
+	for ( unsigned int i = 0; i < n; ++i )
+		Queues.push_back(new Queue());
+	// worker 0 is the waiting thread
+	for ( unsigned int i = 1; i < n; ++i )
+		Threads.push_back(std::thread ( &TaskPool::workerLoop, this, i ));
+}
+
+TaskPool :: ~TaskPool ( void )
+{
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+		Stop = true;
+	}
+	Changed.notify_all();
+	for ( auto& thread: Threads )
+		thread.join();
+	for ( auto& queue: Queues )
+		delete queue;
+}
+
+/// @return the index of the worker running in the current thread; size() if it is not a pool thread
+unsigned int
+TaskPool :: currentWorker ( void ) const
+{
+	return curPool == this ? curWorker : size();
+}
+
+/// get a task for the worker I, steal it if necessary; @return false if there are no tasks
+bool
+TaskPool :: getTask ( unsigned int i, Task& task )
+{
+	// own tasks are taken LIFO: the latest ones are likely to be warm in cache
+	{
+		Queue& own = *Queues[i];
+		std::lock_guard<std::mutex> guard(own.Lock);
+		if ( !own.Tasks.empty() )
+		{
+			task.swap(own.Tasks.back());
+			own.Tasks.pop_back();
+			--nQueued;
+			return true;
+		}
+	}
+
+	// steal FIFO from the others, starting from the next worker to spread the contention
+	for ( unsigned int k = 1, n = size(); k < n && nQueued > 0; ++k )
+	{
+		Queue& victim = *Queues[(i+k)%n];
+		std::lock_guard<std::mutex> guard(victim.Lock);
+		if ( !victim.Tasks.empty() )
+		{
+			task.swap(victim.Tasks.front());
+			victim.Tasks.pop_front();
+			--nQueued;
+			++nStolen;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// run TASK by the worker I
+void
+TaskPool :: runTask ( unsigned int i, Task& task )
+{
+	if ( !Cancelled )
+	{
+		try
+		{
+			task(i);
+		}
+		catch ( const EFPPTimeout& )
+		{
+			// timeout is per-test, so the other tasks could be done in time
+			++nTimeouts;
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> guard(Lock);
+			if ( !Error )
+				Error = std::current_exception();
+			Cancelled = true;
+		}
+	}
+
+	task = nullptr;
+	if ( --nPending == 0 )
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+		Changed.notify_all();
+	}
+}
+
+/// main loop of the worker I
+void
+TaskPool :: workerLoop ( unsigned int i )
+{
+	curPool = this;
+	curWorker = i;
+	Task task;
+
+	for (;;)
+	{
+		if ( getTask ( i, task ) )
+		{
+			runTask ( i, task );
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(Lock);
+		Changed.wait ( guard, [this] { return Stop || nQueued > 0; } );
+		if ( Stop )
+			return;
+	}
+}
+
+/// submit a TASK; could be called from the tasks as well
+void
+TaskPool :: submit ( const Task& task )
+{
+	unsigned int i = currentWorker();
+	if ( i == size() )	// outside of the pool: distribute round-robin
+		i = nextQueue++ % size();
+
+	++nPending;
+	{
+		Queue& queue = *Queues[i];
+		std::lock_guard<std::mutex> guard(queue.Lock);
+		queue.Tasks.push_back(task);
+		++nQueued;
+	}
+
+	// sleeping workers check the counter under the lock, so no wakeup is lost
+	std::lock_guard<std::mutex> guard(Lock);
+	Changed.notify_all();
+}
+
+/// help the workers to run the submitted tasks; the call returns when all of them are done or dropped
+bool
+TaskPool :: wait ( void )
+{
+	const TaskPool* savedPool = curPool;
+	unsigned int savedWorker = curWorker;
+	curPool = this;
+	curWorker = 0;
+
+	Task task;
+	while ( nPending > 0 )
+	{
+		// the hook might call the user code, so check it only in the waiting thread
+		if ( !Cancelled && isCancelled && isCancelled() )
+			Cancelled = true;
+
+		if ( getTask ( 0, task ) )
+		{
+			runTask ( 0, task );
+			continue;
+		}
+
+		// wake up from time to time to check the hook
+		std::unique_lock<std::mutex> guard(Lock);
+		Changed.wait_for ( guard, std::chrono::milliseconds(100), [this] { return nPending == 0 || nQueued > 0; } );
+	}
+
+	curPool = savedPool;
+	curWorker = savedWorker;
+
+	bool done = !Cancelled;
+	Cancelled = false;
+	if ( Error )
+	{
+		std::exception_ptr error;
+		error.swap(Error);
+		std::rethrow_exception(error);
+	}
+	return done;
+}
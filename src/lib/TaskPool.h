@@ -0,0 +1,125 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool of worker threads with a work-stealing scheduler. Every worker has its
+ * own queue: it takes tasks from the back of it and steals from the front of
+ * the others' ones when it is empty. Tasks start as soon as they are
+ * submitted. The thread that waits for the tasks is the worker 0, so the pool
+ * of size N has N-1 threads of its own. A task gets the index of the worker
+ * running it, so the users keep per-worker contexts (like private reasoners)
+ * in vectors of the size of the pool.
+ */
+class TaskPool
+{
+public:		// types
+		/// task; the argument is the index of the worker that runs it
+	typedef std::function<void(unsigned int)> Task;
+		/// cancellation hook; @return true iff the rest of the tasks should be dropped
+	typedef std::function<bool(void)> CancelHook;
+
+protected:	// types
+		/// queue of the tasks of a single worker
+	struct Queue
+	{
+			/// lock for the tasks
+		std::mutex Lock;
+			/// tasks
+		std::deque<Task> Tasks;
+	}; // Queue
+
+protected:	// members
+		/// own threads of the pool
+	std::vector<std::thread> Threads;
+		/// queues of the workers; one per worker
+	std::vector<Queue*> Queues;
+		/// lock for the state changes
+	std::mutex Lock;
+		/// signal for the state changes: new tasks, last task done, stop
+	std::condition_variable Changed;
+		/// cancellation hook; checked by the waiting thread only
+	CancelHook isCancelled;
+		/// exception thrown by a task (if any); it is rethrown in the waiting thread
+	std::exception_ptr Error;
+		/// number of tasks in the queues
+	std::atomic<std::size_t> nQueued;
+		/// number of tasks not finished yet
+	std::atomic<std::size_t> nPending;
+		/// queue to put the next task from the outside of the pool
+	std::atomic<unsigned int> nextQueue;
+		/// true iff the rest of the tasks should be dropped
+	std::atomic<bool> Cancelled;
+		/// true iff the threads should finish
+	bool Stop;
+		/// number of tasks stolen from the other workers
+	std::atomic<unsigned long> nStolen;
+		/// number of tasks finished by timeout
+	std::atomic<unsigned long> nTimeouts;
+
+protected:	// methods
+		/// @return the index of the worker running in the current thread; size() if it is not a pool thread
+	unsigned int currentWorker ( void ) const;
+		/// get a task for the worker I, steal it if necessary; @return false if there are no tasks
+	bool getTask ( unsigned int i, Task& task );
+		/// run TASK by the worker I
+	void runTask ( unsigned int i, Task& task );
+		/// main loop of the worker I
+	void workerLoop ( unsigned int i );
+
+public:		// interface
+		/// init c'tor: create a pool of N workers
+	explicit TaskPool ( unsigned int n );
+		/// no copy c'tor
+	TaskPool ( const TaskPool& ) = delete;
+		/// no assignment
+	TaskPool& operator = ( const TaskPool& ) = delete;
+		/// d'tor: stop all threads; no tasks should be pending
+	~TaskPool ( void );
+
+		/// @return number of workers
+	unsigned int size ( void ) const { return static_cast<unsigned int>(Queues.size()); }
+		/// set the cancellation HOOK
+	void setCancelHook ( const CancelHook& hook ) { isCancelled = hook; }
+
+		/// submit a TASK; could be called from the tasks as well
+	void submit ( const Task& task );
+		/// help the workers to run the submitted tasks; the call returns when all of them are done or dropped
+		/// @return false iff some tasks were dropped due to cancellation; rethrows the exception of a task (if any)
+	bool wait ( void );
+		/// @return the flag that is set when the rest of the tasks should be dropped; the tasks can check it to stop early
+	const std::atomic<bool>& getCancelFlag ( void ) const { return Cancelled; }
+
+		/// @return number of tasks stolen from the other workers
+	unsigned long getNumStolen ( void ) const { return nStolen; }
+		/// @return number of tasks finished by timeout
+	unsigned long getNumTimeouts ( void ) const { return nTimeouts; }
+}; // TaskPool
+
+#endif
@@ -20,6 +20,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 |* Implementation of taxonomy building for the FaCT++  *|
 \*******************************************************/
 
+#include <algorithm>
+
 #include "Taxonomy.h"
 #include "logging.h"
 
@@ -107,6 +109,7 @@ Taxonomy :: finalise ( void )
 			getBottomVertex()->addNeighbour ( !upDirection, *p );
 		}
 	willInsertIntoTaxonomy = false;	// after finalisation one shouldn't add new entries to taxonomy
+	buildIndex();
 }
 
 /// unlink the bottom from the taxonomy
@@ -119,4 +122,140 @@ Taxonomy :: deFinalise ( void )
 		(*p)->removeLink ( !upDirection, bot );
 	bot->clearLinks(upDirection);
 	willInsertIntoTaxonomy = true;	// it's possible again to add entries
+	indexValid = false;
+	UpIndex.clear();
+	DownIndex.clear();
+}
+
+/// build reachability indices for the current graph
+void
+Taxonomy :: buildIndex ( void )
+{
+	// index all the vertices in use but the bottom one
+	TaxVertexVec vertices;
+	getBottomVertex()->setIndex(0);
+	for ( TaxVertexVec::iterator p = Graph.begin()+1, p_end = Graph.end(); p < p_end; ++p )
+		if ( likely((*p)->isInUse()) )
+		{
+			vertices.push_back(*p);
+			(*p)->setIndex(static_cast<unsigned int>(vertices.size()));
+		}
+		else
+			(*p)->setIndex(0);
+
+	UpIndex.build ( vertices, /*upDirection=*/true );
+	DownIndex.build ( vertices, /*upDirection=*/false );
+	indexValid = true;
+}
+
+/// @return true iff SUP is an ancestor of NODE; explore unindexed graph
+bool
+Taxonomy :: isAncestor ( TaxonomyVertex* node, const TaxonomyVertex* sup )
+{
+	for ( TaxonomyVertex::iterator p = node->begin(/*upDirection=*/true), p_end = node->end(/*upDirection=*/true); p != p_end; ++p )
+	{
+		if ( *p == sup )
+			return true;
+		if ( isVisited(*p) )
+			continue;
+		setVisited(*p);
+		if ( isAncestor ( *p, sup ) )
+			return true;
+	}
+	return false;
+}
+
+/********************************************************\
+|* 		Implementation of class Taxonomy::ReachIndex		*|
+\********************************************************/
+
+/// build the index over VERTICES with indices 1..n following links in the given direction
+void
+Taxonomy :: ReachIndex :: build ( const TaxVertexVec& vertices, bool upDirection )
+{
+	size_t n = vertices.size();
+	clear();
+	Order.assign ( n+1, nullptr );
+	Pos.assign ( n+1, 0 );
+	// intervals of a vertex are known when it is done; keep them in the order of positions
+	std::vector<unsigned int> PosFirst ( n+2, 0 );
+	std::vector<unsigned int> Low ( n+1, 0 );
+	std::vector<Interval> merged;
+	unsigned int last = 0;	// last given position
+
+	// DFS stack: vertex and the next neighbour to explore
+	std::vector<std::pair<TaxonomyVertex*, TaxonomyVertex::iterator>> stack;
+	for ( const auto& root: vertices )
+	{
+		if ( Low[root->getIndex()] != 0 )	// already visited
+			continue;
+		Low[root->getIndex()] = last+1;
+		stack.push_back(std::make_pair(root,root->begin(upDirection)));
+		while ( !stack.empty() )
+		{
+			TaxonomyVertex* v = stack.back().first;
+			TaxonomyVertex::iterator& p = stack.back().second;
+			// look for the unvisited neighbour
+			for ( ; p != v->end(upDirection); ++p )
+			{
+				unsigned int index = (*p)->getIndex();
+				if ( index != 0 && Low[index] == 0 )
+					break;
+			}
+			if ( p != v->end(upDirection) )	// tree edge
+			{
+				TaxonomyVertex* w = *p++;
+				Low[w->getIndex()] = last+1;
+				stack.push_back(std::make_pair(w,w->begin(upDirection)));
+				continue;
+			}
+			// all the neighbours are done: V gets the next position
+			stack.pop_back();
+			unsigned int index = v->getIndex();
+			Pos[index] = ++last;
+			Order[last] = v;
+			// collect the tree interval and all the neighbours' intervals
+			merged.clear();
+			merged.push_back(Interval(Low[index],last));
+			for ( TaxonomyVertex::iterator q = v->begin(upDirection), q_end = v->end(upDirection); q != q_end; ++q )
+				if ( (*q)->getIndex() != 0 )
+				{
+					unsigned int w = Pos[(*q)->getIndex()];
+					fpp_assert ( w != 0 );	// taxonomy is a DAG, so all the neighbours are done
+					merged.insert ( merged.end(), Intervals.begin()+PosFirst[w], Intervals.begin()+PosFirst[w+1] );
+				}
+			std::sort ( merged.begin(), merged.end() );
+			PosFirst[last] = static_cast<unsigned int>(Intervals.size());
+			for ( const auto& i: merged )
+				if ( Intervals.size() > PosFirst[last] && i.first <= Intervals.back().second+1 )
+					Intervals.back().second = std::max ( Intervals.back().second, i.second );
+				else
+					Intervals.push_back(i);
+			PosFirst[last+1] = static_cast<unsigned int>(Intervals.size());
+		}
+	}
+
+	// re-index the intervals by the vertex indices
+	First.assign ( n+2, 0 );
+	std::vector<Interval> byIndex;
+	byIndex.reserve(Intervals.size());
+	for ( unsigned int index = 1; index <= n; ++index )
+	{
+		First[index] = static_cast<unsigned int>(byIndex.size());
+		unsigned int p = Pos[index];
+		byIndex.insert ( byIndex.end(), Intervals.begin()+PosFirst[p], Intervals.begin()+PosFirst[p+1] );
+	}
+	First[n+1] = static_cast<unsigned int>(byIndex.size());
+	Intervals.swap(byIndex);
+}
+
+/// @return true iff vertex with index TO is reachable from the vertex with index FROM
+bool
+Taxonomy :: ReachIndex :: reaches ( unsigned int from, unsigned int to ) const
+{
+	unsigned int p = Pos[to];
+	auto begin = Intervals.begin()+First[from], end = Intervals.begin()+First[from+1];
+	// find the last interval that starts not after P
+	auto q = std::upper_bound ( begin, end, Interval(p,static_cast<unsigned int>(-1)) );
+	return q != begin && (q-1)->second >= p;
 }
@@ -32,6 +32,49 @@ protected:	// typedefs
 		/// type for a vector of TaxVertex
 	typedef std::vector<TaxonomyVertex*> TaxVertexVec;
 
+		/**
+		 * Reachability index of a finalised taxonomy in one direction, built by
+		 * the tree-cover interval labelling. Vertices get positions in the
+		 * post-order of a DFS; the vertices reachable from a vertex are exactly
+		 * the ones which positions are in its (few) intervals. The bottom vertex
+		 * is not indexed, as it is reachable from everything going down.
+		 */
+	class ReachIndex
+	{
+	protected:	// types
+			/// interval [first,second] of positions
+		typedef std::pair<unsigned int, unsigned int> Interval;
+
+	protected:	// members
+			/// vertices by their positions (1-based)
+		TaxVertexVec Order;
+			/// positions of the vertices; indexed by the vertex index
+		std::vector<unsigned int> Pos;
+			/// intervals of the vertex with index I are [First[I], First[I+1]) in Intervals
+		std::vector<unsigned int> First;
+			/// all the intervals
+		std::vector<Interval> Intervals;
+
+	public:		// interface
+			/// build the index over VERTICES with indices 1..n following links in the given direction
+		void build ( const TaxVertexVec& vertices, bool upDirection );
+			/// clear the index
+		void clear ( void ) { Order.clear(); Pos.clear(); First.clear(); Intervals.clear(); }
+
+			/// @return true iff vertex with index TO is reachable from the vertex with index FROM
+		bool reaches ( unsigned int from, unsigned int to ) const;
+			/// apply ACTOR to all vertices reachable from the vertex with index FROM except itself
+		template<class Actor>
+		void apply ( unsigned int from, Actor& actor ) const
+		{
+			const TaxonomyVertex* self = Order[Pos[from]];
+			for ( unsigned int i = First[from], i_end = First[from+1]; i < i_end; ++i )
+				for ( unsigned int p = Intervals[i].first; p <= Intervals[i].second; ++p )
+					if ( Order[p] != self )
+						actor.apply(*Order[p]);
+		}
+	}; // ReachIndex
+
 protected:	// members
 		/// array of taxonomy vertices
 	TaxVertexVec Graph;
@@ -46,6 +89,13 @@ protected:	// members
 		/// behaviour flag: if true, insert temporary vertex into taxonomy
 	bool willInsertIntoTaxonomy;
 
+		/// reachability index for the ancestors
+	ReachIndex UpIndex;
+		/// reachability index for the descendants
+	ReachIndex DownIndex;
+		/// true iff the reachability indices correspond to the current graph
+	bool indexValid;
+
 public:		// classification interface
 
 	//-----------------------------------------------------------------
@@ -77,6 +127,13 @@ public:		// classification interface
 	void deFinalise ( void );
 
 protected:	// methods
+		/// build reachability indices for the current graph
+	void buildIndex ( void );
+		/// @return true iff NODE is in the reachability indices
+	bool isIndexed ( const TaxonomyVertex* node ) const { return indexValid && node->getIndex() != 0; }
+		/// @return true iff SUP is an ancestor of NODE; explore unindexed graph
+	bool isAncestor ( TaxonomyVertex* node, const TaxonomyVertex* sup );
+
 		/// apply ACTOR to subgraph starting from NODE as defined by flags
 	template<bool onlyDirect, bool upDirection, class Actor>
 	void getRelativesInfoRec ( TaxonomyVertex* node, Actor& actor )
@@ -103,6 +160,7 @@ public:		// interface
 	Taxonomy ( const ClassifiableEntry* pTop, const ClassifiableEntry* pBottom )
 		: Current(new TaxonomyVertex())
 		, willInsertIntoTaxonomy (true)
+		, indexValid(false)
 	{
 		Graph.push_back (new TaxonomyVertex(pBottom));	// bottom
 		Graph.push_back (new TaxonomyVertex(pTop));		// top
@@ -133,6 +191,15 @@ public:		// interface
 	const TaxonomyVertex* getCurrent ( void ) const { return Current; }
 		/// set current to a given node
 	void setCurrent ( TaxonomyVertex* cur ) { Current = cur; }
+		/// @return current (that keeps the position of a classified query) and use a new one from now on; the caller owns the result
+	TaxonomyVertex* releaseCurrent ( void )
+	{
+		TaxonomyVertex* ret = Current;
+		Current = new TaxonomyVertex();
+		return ret;
+	}
+		/// @return true iff V is the node for the fresh entities
+	bool isFreshVertex ( const TaxonomyVertex* v ) const { return v == &FreshNode; }
 
 		/// apply ACTOR to subgraph starting from NODE as defined by flags;
 	template<bool needCurrent, bool onlyDirect, bool upDirection, class Actor>
@@ -145,12 +212,39 @@ public:		// interface
 			if ( actor.apply(*node) && onlyDirect )
 				return;
 
+		// all the relatives of an indexed node are known without traversal
+		if ( !onlyDirect && isIndexed(node) )
+		{
+			if ( upDirection )
+				UpIndex.apply ( node->getIndex(), actor );
+			else
+			{
+				DownIndex.apply ( node->getIndex(), actor );
+				actor.apply(*getBottomVertex());
+			}
+			return;
+		}
+
 		for ( TaxonomyVertex::iterator p = node->begin(upDirection), p_end = node->end(upDirection); p != p_end; ++p )
 			getRelativesInfoRec<onlyDirect, upDirection> ( *p, actor );
 
 		clearVisited();
 	}
 
+		/// @return true iff the entry of SUB is subsumed by the entry of SUP
+	bool isSubsumedBy ( TaxonomyVertex* sub, TaxonomyVertex* sup )
+	{
+		if ( sub == sup || sup == getTopVertex() || sub == getBottomVertex() )
+			return true;
+		if ( sup == getBottomVertex() )
+			return false;
+		if ( isIndexed(sub) && isIndexed(sup) )
+			return UpIndex.reaches ( sub->getIndex(), sup->getIndex() );
+		bool ret = isAncestor ( sub, sup );
+		clearVisited();
+		return ret;
+	}
+
 	// taxonomy info access
 
 		/// print taxonomy info to a stream
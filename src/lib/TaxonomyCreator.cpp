@@ -175,6 +175,23 @@ TaxonomyCreator :: propagateFalseDown ( TaxonomyVertex* node )
 //--	DFS-based classification methods
 //-----------------------------------------------------------------
 
+/// drop the classification interrupted by an exception, so the next one starts from scratch
+void
+TaxonomyCreator :: abortClassification ( void )
+{
+	// the entries on the stack are not classified; the one being classified refers to the current vertex
+	while ( !waitStack.empty() )
+	{
+		ClassifiableEntry* p = waitStack.top();
+		if ( p->getTaxVertex() == pTax->getCurrent() )
+			p->setTaxVertex(nullptr);
+		removeTop();
+	}
+	Syns.clear();
+	pTax->getCurrent()->clear();
+	clearLabels();
+}
+
 ClassifiableEntry*
 TaxonomyCreator :: prepareTS ( ClassifiableEntry* cur )
 {
@@ -222,6 +222,8 @@ protected:	// methods
 		performClassification();
 		removeTop();
 	}
+		/// drop the classification interrupted by an exception, so the next one starts from scratch
+	void abortClassification ( void );
 		/// propagate the TRUE value of the KS subsumption up the hierarchy
 	void propagateTrueUp ( TaxonomyVertex* node );
 		/// propagate the FALSE value of the KS subsumption down the hierarchy
@@ -270,7 +272,15 @@ public:		// interface
 		// don't classify artificial concepts
 		if ( p->isNonClassifiable() )
 			return;
-		prepareTS(p);
+		try
+		{
+			prepareTS(p);
+		}
+		catch(...)
+		{	// e.g., the deadline has passed; the entries could be classified later
+			abortClassification();
+			throw;
+		}
 	}
  		/// clear all labels from Taxonomy vertices
 	void clearLabels ( void ) { pTax->clearVisited(); valueLabel.newLabel(); }
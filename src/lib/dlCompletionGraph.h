@@ -22,7 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <vector>
 
 #include "globaldef.h"
-#include "DeletelessAllocator.h"
+#include "SlabAllocator.h"
 #include "dlCompletionTree.h"
 #include "dlCompletionTreeArc.h"
 #include "tSaveStack.h"
@@ -71,7 +71,9 @@ private:	// constants
 
 private:	// members
 		/// allocator for edges
-	DeletelessAllocator<DlCompletionTreeArc> CTEdgeHeap;
+	DlCompletionTreeArc::EdgeAllocator CTEdgeHeap;
+		/// storage for the nodes: nodes with adjacent IDs are adjacent in memory
+	SlabAllocator<DlCompletionTree> NodeSlabs;
 
 protected:	// members
 		/// heap itself
@@ -128,7 +130,7 @@ protected:	// methods
 	void initNodeArray ( iterator b, iterator e )
 	{
 		for ( iterator p = b; p != e; ++p )
-			*p = new DlCompletionTree(nodeId++);
+			*p = NodeSlabs.create(nodeId++);
 	}
 		/// increase heap size
 	void grow ( void )
@@ -262,7 +264,8 @@ protected:	// methods
 public:		// interface
 		/// c'tor: make INIT_SIZE objects
 	DlCompletionGraph ( unsigned int initSize, DlSatTester* p )
-		: NodeBase(initSize)
+		: NodeSlabs(initSize)
+		, NodeBase(initSize)
 		, pReasoner(p)
 		, nodeId(0)
 		, endUsed(0)
@@ -278,12 +281,8 @@ public:		// interface
 	DlCompletionGraph ( const DlCompletionGraph& ) = delete;
 		/// no assignment
 	DlCompletionGraph& operator = ( const DlCompletionGraph& ) = delete;
-		/// d'tor: delete all allocated nodes
-	~DlCompletionGraph ( void )
-	{
-		for ( iterator p = NodeBase.begin(); p != NodeBase.end(); ++p )
-			delete *p;
-	}
+		/// d'tor: all allocated nodes are deleted by the NodeSlabs
+	~DlCompletionGraph ( void ) {}
 
 	// flag setting
 
@@ -478,6 +477,8 @@ public:		// interface
 	bool setCurIR ( DlCompletionTree* node, const DepSet& ds );
 		/// finilise current IR set
 	void finiIR ( void );
+		/// make a new NODE member of all the IR sets of the SAMPLE with additional dep-set DS
+	void copyIR ( DlCompletionTree* node, const DlCompletionTree* sample, const DepSet& ds ) { updateIR ( node, sample, ds ); }
 
 		/// check if P and Q are in IR; if so, put the clash-set to DEP
 	bool nonMergable ( const DlCompletionTree* p, const DlCompletionTree* q, DepSet& dep ) const;
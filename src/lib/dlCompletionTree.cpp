@@ -30,7 +30,8 @@ DlCompletionTree :: isTSuccLabelled ( const TRole* R, BipolarPointer C ) const
 
 	// check all other successors
 	const DlCompletionTree* ret = nullptr;
-	for ( const_edge_iterator p = begin(), p_end = end(); p < p_end; ++p )
+	EdgeRange edges = neighbours(R);
+	for ( const_edge_iterator p = edges.begin(), p_end = edges.end(); p < p_end; ++p )
 		if ( (*p)->isSuccEdge() &&
 			 (*p)->isNeighbour(R) &&
 			 !(*p)->isReflexiveEdge() &&	// prevent cycles
@@ -53,7 +54,8 @@ DlCompletionTree :: isTPredLabelled ( const TRole* R, BipolarPointer C, const Dl
 
 	// check all other successors
 	const DlCompletionTree* ret = nullptr;
-	for ( const_edge_iterator p = begin(), p_end = end(); p < p_end; ++p )
+	EdgeRange edges = neighbours(R);
+	for ( const_edge_iterator p = edges.begin(), p_end = edges.end(); p < p_end; ++p )
 		if ( (*p)->isSuccEdge() && (*p)->isNeighbour(R) && (*p)->getArcEnd() != from &&
 			 (ret = (*p)->getArcEnd()->isTSuccLabelled(R,C)) != nullptr )
 			return ret;
@@ -68,7 +70,8 @@ DlCompletionTree :: isTPredLabelled ( const TRole* R, BipolarPointer C, const Dl
 const DlCompletionTree*
 DlCompletionTree :: isNSomeApplicable ( const TRole* R, BipolarPointer C ) const
 {
-	for ( DlCompletionTree::const_edge_iterator p = begin(), p_end = end(); p < p_end; ++p )
+	EdgeRange edges = neighbours(R);
+	for ( const_edge_iterator p = edges.begin(), p_end = edges.end(); p < p_end; ++p )
 		if ( (*p)->isNeighbour(R) && (*p)->getArcEnd()->isLabelledBy(C) )
 			return (*p)->getArcEnd();	// already contained such a label
 
@@ -79,8 +82,9 @@ const DlCompletionTree*
 DlCompletionTree :: isTSomeApplicable ( const TRole* R, BipolarPointer C ) const
 {
 	const DlCompletionTree* ret = nullptr;
+	EdgeRange edges = neighbours(R);
 
-	for ( DlCompletionTree::const_edge_iterator p = begin(), p_end = end(); p < p_end; ++p )
+	for ( const_edge_iterator p = edges.begin(), p_end = edges.end(); p < p_end; ++p )
 		if ( (*p)->isNeighbour(R) )
 		{
 			if ( (*p)->isPredEdge() )
@@ -95,6 +99,51 @@ DlCompletionTree :: isTSomeApplicable ( const TRole* R, BipolarPointer C ) const
 	return nullptr;
 }
 
+//----------------------------------------------
+// role index methods
+//----------------------------------------------
+
+void DlCompletionTree :: addToRoleIndex ( DlCompletionTreeArc* p, const TRole* R )
+{
+	// the edge is an R-neighbour and a neighbour wrt all super-roles of R
+	if ( R->getIndex() >= RoleNeighbours.size() )
+		RoleNeighbours.resize(R->getIndex()+1);
+	RoleNeighbours[R->getIndex()].push_back(p);
+	for ( const auto& sup: R->ancestors() )
+		if ( sup->isDataRole() == R->isDataRole() )
+		{
+			if ( sup->getIndex() >= RoleNeighbours.size() )
+				RoleNeighbours.resize(sup->getIndex()+1);
+			RoleNeighbours[sup->getIndex()].push_back(p);
+		}
+}
+
+void DlCompletionTree :: removeFromRoleIndex ( const TRole* R )
+{
+	// the edges are removed in the reverse order, so the edge is the last one everywhere
+	RoleNeighbours[R->getIndex()].pop_back();
+	for ( const auto& sup: R->ancestors() )
+		if ( sup->isDataRole() == R->isDataRole() )
+			RoleNeighbours[sup->getIndex()].pop_back();
+}
+
+void DlCompletionTree :: buildRoleIndex ( void )
+{
+	// use the original roles: purged edges could be restored later
+	for ( size_t i = 0, n = Neighbour.size(); i < n; ++i )
+		addToRoleIndex ( Neighbour[i], NeighbourRole[i] );
+	roleIndexed = true;
+}
+
+void DlCompletionTree :: truncateNeighbours ( size_t n )
+{
+	if ( roleIndexed )
+		for ( size_t i = Neighbour.size(); i > n; --i )
+			removeFromRoleIndex(NeighbourRole[i-1]);
+	Neighbour.resize(n);
+	NeighbourRole.resize(n);
+}
+
 #ifdef RKG_IR_IN_NODE_LABEL
 	//----------------------------------------------
 	// inequality relation methods
@@ -171,12 +220,12 @@ void DlCompletionTree :: restore ( SaveState* nss )
 
 	// remove new neighbours
 #ifndef RKG_USE_DYNAMIC_BACKJUMPING
-	Neighbour.resize(nss->nNeighbours);
+	truncateNeighbours(nss->nNeighbours);
 #else
 	for ( int j = Neighbour.size()-1; j >= 0; --j )
 		if ( Neighbour[j]->Node->creLevel <= getCurLevel() )
 		{
-			Neighbour.resize(j+1);
+			truncateNeighbours(j+1);
 			break;
 		}
 #endif
@@ -109,6 +109,18 @@ protected:	// internal classes
 		void restore ( void ) { p->cached = cached; }
 	}; // CacheRestorer
 
+		/// restore multiplicity of a proxy node
+	class MultiplicityRestorer: public TRestorer
+	{
+	protected:
+		DlCompletionTree* p;
+		unsigned int n;
+	public:
+		MultiplicityRestorer ( DlCompletionTree* q ) : p(q), n(q->Multiplicity) {}
+		virtual ~MultiplicityRestorer ( void ) {}
+		void restore ( void ) { p->Multiplicity = n; }
+	}; // MultiplicityRestorer
+
 #ifdef RKG_IR_IN_NODE_LABEL
 		/// restore node after IR set change
 	class IRRestorer: public TRestorer
@@ -132,6 +144,24 @@ public:		// type interface
 		/// const iterator on edges
 	typedef ArcCollection::const_iterator const_edge_iterator;
 
+		/// RO range of edges
+	class EdgeRange
+	{
+	protected:	// members
+			/// the first edge
+		const_edge_iterator b;
+			/// the edge after the last one
+		const_edge_iterator e;
+
+	public:		// interface
+			/// init c'tor
+		EdgeRange ( const_edge_iterator begin, const_edge_iterator end ) : b(begin), e(end) {}
+			/// @return the first edge
+		const_edge_iterator begin ( void ) const { return b; }
+			/// @return the edge after the last one
+		const_edge_iterator end ( void ) const { return e; }
+	}; // EdgeRange
+
 		/// RO iterator on label
 	typedef CGLabel::const_iterator const_label_iterator;
 
@@ -149,6 +179,10 @@ protected:	// members
 #endif
 		/// Neighbours information
 	ArcCollection Neighbour;
+		/// roles the neighbours were created with (the role of an edge is cleared when the edge is purged)
+	std::vector<const TRole*> NeighbourRole;
+		/// edges labelled with R or its sub-roles for every role R; maintained only for nodes with many neighbours
+	std::vector<ArcCollection> RoleNeighbours;
 		/// pointer to last saved node
 	TSaveList<SaveState> saves;
 		/// ID of node (used in print)
@@ -176,14 +210,35 @@ protected:	// members
 			This flag may be viewed as a cache for a 'blocked' status
 		*/
 	unsigned int affected : 1;
+		/// flag whether the edges are indexed by roles
+	unsigned int roleIndexed : 1;
 		/// the rest
-	unsigned int unused : 27;
+	unsigned int unused : 26;
 
 		/// level of a nominal node; 0 means blockable one
 	CTNominalLevel nominalLevel;
+		/// number of identical different nodes the node stands for; more than 1 for the proxy of an at-least restriction
+	unsigned int Multiplicity;
+
+protected:	// constants
+		/// number of neighbours that makes a node to index its edges by roles
+	static const size_t RoleIndexThreshold = 32;
 
 protected:	// methods
 
+	//----------------------------------------------
+	// role index methods
+	//----------------------------------------------
+
+		/// add an edge P labelled with R to the index
+	void addToRoleIndex ( DlCompletionTreeArc* p, const TRole* R );
+		/// remove the last edge labelled with R from the index
+	void removeFromRoleIndex ( const TRole* R );
+		/// index all the edges by roles
+	void buildRoleIndex ( void );
+		/// remove all the neighbours after the first N ones
+	void truncateNeighbours ( size_t n );
+
 	//----------------------------------------------
 	// blocking support methods
 	//----------------------------------------------
@@ -329,7 +384,15 @@ public:		// methods
 	~DlCompletionTree ( void ) { saves.clear(); }
 
 		/// add given arc P as a neighbour
-	void addNeighbour ( DlCompletionTreeArc* p ) { Neighbour.push_back(p); }
+	void addNeighbour ( DlCompletionTreeArc* p )
+	{
+		Neighbour.push_back(p);
+		NeighbourRole.push_back(p->getRole());
+		if ( roleIndexed )
+			addToRoleIndex ( p, p->getRole() );
+		else if ( Neighbour.size() >= RoleIndexThreshold )
+			buildRoleIndex();
+	}
 
 		/// get Node's id
 	unsigned int getId ( void ) const { return id; }
@@ -345,6 +408,24 @@ public:		// methods
 		return ret;
 	}
 
+	// proxy node methods
+
+		/// @return the number of nodes the node stands for
+	unsigned int getMultiplicity ( void ) const { return Multiplicity; }
+		/// check whether the node stands for several nodes
+	bool isProxy ( void ) const { return Multiplicity > 1; }
+		/// make a new node stand for N nodes
+	void setMultiplicity ( unsigned int n ) { Multiplicity = n; }
+		/// make the node stand for itself only
+	TRestorer* clearMultiplicity ( void )
+	{
+		if ( Multiplicity == 1 )
+			return nullptr;
+		TRestorer* ret = new MultiplicityRestorer(this);
+		Multiplicity = 1;
+		return ret;
+	}
+
 	// data node methods
 
 	bool isDataNode ( void ) const { return flagDataNode; }
@@ -371,6 +452,8 @@ public:		// methods
 	void addConcept ( const ConceptWDep& p, bool isComplex ) { Label.getLabel(isComplex).add(p); }
 		/// set the Init concept
 	void setInit ( BipolarPointer p ) { Init = p; }
+		/// get the Init concept
+	BipolarPointer getInit ( void ) const { return Init; }
 
 	//----------------------------------------------
 	// children/parent access interface
@@ -381,6 +464,16 @@ public:		// methods
 	const_edge_iterator end ( void ) const { return Neighbour.end(); }
 	edge_iterator begin ( void ) { return Neighbour.begin(); }
 	edge_iterator end ( void ) { return Neighbour.end(); }
+		/// @return edges that could be R-neighbours; it is still necessary to check them with isNeighbour(R)
+	EdgeRange neighbours ( const TRole* R ) const
+	{
+		if ( !roleIndexed )
+			return EdgeRange ( begin(), end() );
+		if ( R->getIndex() >= RoleNeighbours.size() )
+			return EdgeRange ( end(), end() );
+		const ArcCollection& edges = RoleNeighbours[R->getIndex()];
+		return EdgeRange ( edges.begin(), edges.end() );
+	}
 
 		/// return true if node is a non-root; works for reflexive roles
 	bool hasParent ( void ) const
@@ -564,9 +657,9 @@ public:		// methods
 		/// check if edge to NODE is labeled by R; return NULL if does not
 	DlCompletionTreeArc* getEdgeLabelled ( const TRole* R, const DlCompletionTree* node ) const
 	{
-		for ( const_edge_iterator p = begin(), p_end = end(); p < p_end; ++p )
-			if ( (*p)->getArcEnd() == node && (*p)->isNeighbour(R) )
-				return *p;
+		for ( const auto& edge: neighbours(R) )
+			if ( edge->getArcEnd() == node && edge->isNeighbour(R) )
+				return edge;
 		return nullptr;
 	}
 		/// check if parent arc is labeled by R; works only for blockable nodes
@@ -632,6 +725,7 @@ inline void DlCompletionTree :: init ( unsigned int level )
 {
 	flagDataNode = false;
 	nominalLevel = BlockableLevel;
+	Multiplicity = 1;
 	curLevel = level;
 	cached = false;
 	affected = true;	// every (newly created) node can be blocked
@@ -647,6 +741,10 @@ inline void DlCompletionTree :: init ( unsigned int level )
 	IR.clear();
 #endif
 	Neighbour.clear();
+	NeighbourRole.clear();
+	for ( auto& edges: RoleNeighbours )
+		edges.clear();
+	roleIndexed = false;
 	Blocker = nullptr;
 	pDep.clear();
 }
@@ -20,7 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define DLCOMPLETIONTREEARC_H
 
 #include "globaldef.h"
-#include "DeletelessAllocator.h"
+#include "SlabAllocator.h"
 #include "DepSet.h"
 #include "tRole.h"
 #include "tRestorer.h"
@@ -32,7 +32,7 @@ class DlCompletionTreeArc
 friend class DlCompletionGraph;
 public:		// external type definitions
 		/// type for the edges allocator
-	typedef DeletelessAllocator<DlCompletionTreeArc> EdgeAllocator;
+	typedef SlabDeletelessAllocator<DlCompletionTreeArc> EdgeAllocator;
 
 protected:	// members
 		/// pointer to "to" node
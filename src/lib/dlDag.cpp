@@ -16,6 +16,8 @@ License along with this library; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+#include <algorithm>
+
 #include "dlDag.h"
 
 #include "logging.h"
@@ -28,10 +30,11 @@ DLDag :: DLDag ( const ifOptionSet* Options )
 	, indexLE(*this)
 	, finalDagSize(0)
 	, nCacheHits(0)
+	, activityOrder(false)
 	, useDLVCache(true)
 {
-	Heap.push_back ( new DLVertex (dtBad) );	// empty vertex -- bpINVALID
-	Heap.push_back ( new DLVertex (dtTop) );
+	directAdd ( new DLVertex (dtBad) );	// empty vertex -- bpINVALID
+	directAdd ( new DLVertex (dtTop) );
 
 	readConfig ( Options );
 }
@@ -62,6 +65,7 @@ DLDag :: removeQuery ( void )
 		delete v;
 	}
 	Heap.resize(finalDagSize);
+	Tags.resize(finalDagSize);
 }
 
 void DLDag :: readConfig ( const ifOptionSet* Options )
@@ -98,6 +102,8 @@ DLDag :: setOrderDefaults ( const char* defSat, const char* defSub )
 /// set OR sort flags based on given option string
 void DLDag :: setOrderOptions ( const char* opt )
 {
+	activityOrder = false;
+
 	// 0x means not to use OR sort
 	if ( opt[0] == '0' )
 		return;
@@ -105,8 +111,11 @@ void DLDag :: setOrderOptions ( const char* opt )
 	sortAscend = (opt[1] == 'a');
 	preferNonGen = (opt[2] == 'p');
 
+	// Ax means dynamic order; the disjuncts are kept sorted by size to break the ties
+	activityOrder = (opt[0] == 'A');
+
 	// all statistics use negative version (as it is used in disjunctions)
-	iSort = opt[0] == 'S' ? DLVertex::getStatIndexSize(false)
+	iSort = opt[0] == 'S' || opt[0] == 'A' ? DLVertex::getStatIndexSize(false)
 		  : opt[0] == 'D' ? DLVertex::getStatIndexDepth(false)
 		  : opt[0] == 'B' ? DLVertex::getStatIndexBranch(false)
 		  : opt[0] == 'G' ? DLVertex::getStatIndexGener(false)
@@ -301,6 +310,28 @@ bool DLDag :: less ( BipolarPointer p1, BipolarPointer p2 ) const
 		return key2 < key1;
 }
 
+/// sort the DISJUNCTS wrt their scores in ACTIVITY and the chosen sort order
+
+// ascending order means that the least active disjunct, i.e., the one that
+// was involved in the least number of the recent clashes, is tried first
+void DLDag :: sortByActivity ( std::vector<BipolarPointer>& Disjuncts, const TActivityScores& Activity ) const
+{
+	auto comp = [this,&Activity] ( BipolarPointer p1, BipolarPointer p2 ) -> bool
+	{
+		// idea: any positive disjunct (ie, negative AND entry) should go first
+		if ( preferNonGen && isPositive(p1) != isPositive(p2) )
+			return isPositive(p1);
+
+		double key1 = Activity.get(p1);
+		double key2 = Activity.get(p2);
+
+		// return "less" wrt sortAscend
+		return sortAscend ? key1 < key2 : key2 < key1;
+	};
+	// the disjuncts with the same score keep the size order of the DAG
+	std::stable_sort ( Disjuncts.begin(), Disjuncts.end(), comp );
+}
+
 #ifdef RKG_PRINT_DAG_USAGE
 /// print usage of DAG
 void DLDag :: PrintDAGUsage ( std::ostream& o ) const
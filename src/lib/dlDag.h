@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tRole.h"
 #include "ConceptWithDep.h"
 #include "tNECollection.h"
+#include "tActivityScores.h"
 
 class RoleMaster;
 class TConcept;
@@ -46,6 +47,8 @@ public:		// types
 protected:	// members
 		/// body of DAG
 	HeapType Heap;
+		/// tags of all the vertices (in sync with the Heap)
+	std::vector<unsigned char> Tags;
 		/// all the AND nodes (needs to recompute)
 	StatVector listAnds;
 		/// hash-table for vertices (and, all, LE) fast search
@@ -72,6 +75,8 @@ protected:	// members
 	bool sortAscend;
 		/// prefer non-generating rules in OR orderings
 	bool preferNonGen;
+		/// order OR arguments by the activity scores of the disjuncts instead of the static statistics
+	bool activityOrder;
 
 		/// flag whether cache should be used
 	bool useDLVCache;
@@ -91,7 +96,7 @@ protected:	// methods
 			 Order = n >= 2 ? str[1] : 'a',
 			 NGPref = n == 3 ? str[2] : 'p';
 		return ( Method == 'S' || Method == 'D' || Method == 'F' ||
-				 Method == 'B' || Method == 'G' || Method == '0' )
+				 Method == 'B' || Method == 'G' || Method == 'A' || Method == '0' )
 			&& ( Order == 'a' || Order == 'd' ) && ( NGPref == 'p' || NGPref == 'n' );
 	}
 		/// gather vertex statistics (no freq)
@@ -189,6 +194,7 @@ public:		// interface
 	{
 		BipolarPointer toReturn = BipolarPointer(Heap.size());
 		Heap.push_back(v);
+		Tags.push_back((unsigned char)v->Type());
 		// return an index of just added entry
 		return toReturn;
 	}
@@ -209,6 +215,10 @@ public:		// interface
 	void setExpressionCache ( bool val ) { useDLVCache = val; }
 		/// return true if p1 is less than p2 using chosen sort order
 	bool less ( BipolarPointer p1, BipolarPointer p2 ) const;
+		/// @return true iff the disjuncts are ordered by the activity scores during the reasoning
+	bool useActivityOrder ( void ) const { return activityOrder; }
+		/// sort the DISJUNCTS wrt their scores in ACTIVITY and the chosen sort order
+	void sortByActivity ( std::vector<BipolarPointer>& Disjuncts, const TActivityScores& Activity ) const;
 
 		/// access by index (non-const version)
 	DLVertex& operator [] ( BipolarPointer i )
@@ -237,11 +247,19 @@ public:		// interface
 	{
 		delete Heap[getValue(i)];
 		Heap[getValue(i)] = v;
+		Tags[getValue(i)] = (unsigned char)v->Type();
 		v->setConcept(C);
 	}
 
+		/// get the tag of the vertex I without going through the vertex; the same as (*this)[i].Type()
+	DagTag getTag ( BipolarPointer i ) const { return DagTag(Tags[getValue(i)]); }
+		/// get the tag of the vertex in complex concept
+	DagTag getTag ( const ConceptWDep& cwd ) const { return getTag(cwd.bp()); }
+
 		/// get size of DAG
 	size_t size ( void ) const { return Heap.size (); }
+		/// @return true iff P is a part of a query; such entries could be re-used for another query
+	bool isQueryEntry ( BipolarPointer p ) const { return getValue(p) >= finalDagSize; }
 		/// get approximation of the size after query is added
 	size_t maxSize ( void ) const { return size() + ( size() < 220 ? 10 : size()/20 ); }
 		/// set the final DAG size
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "procTimer.h"
 #include "dumpLisp.h"
 #include "logging.h"
+#include "CachePrefetcher.h"
 
 // uncomment the following line to print currently checking subsumption
 //#define FPP_DEBUG_PRINT_CURRENT_SUBSUMPTION
@@ -37,7 +38,11 @@ TBox :: TBox ( const ifOptionSet* Options, const std::string& TopORoleName, cons
 	: DLHeap(Options)
 	, stdReasoner(nullptr)
 	, nomReasoner(nullptr)
+	, pTaskPool(nullptr)
+	, pPrefetcher(nullptr)
+	, pSubBatch(nullptr)
 	, pMonitor(nullptr)
+	, pDeadline(nullptr)
 	, pTax(nullptr)
 	, pTaxCreator(nullptr)
 	, pName2Sig(nullptr)
@@ -45,6 +50,8 @@ TBox :: TBox ( const ifOptionSet* Options, const std::string& TopORoleName, cons
 	, Status(kbLoading)
 	, curFeature(nullptr)
 	, pQuery(nullptr)
+	, nQueryConcepts(0)
+	, QueryEpoch(0)
 	, Concepts("concept")
 	, Individuals("individual")
 	, ORM ( /*data=*/false, TopORoleName, BotORoleName )
@@ -55,11 +62,15 @@ TBox :: TBox ( const ifOptionSet* Options, const std::string& TopORoleName, cons
 	, nR(0)
 	, auxConceptID(0)
 	, testTimeout(0)
+	, nCacheThreads(0)
+	, nSubThreads(0)
+	, algebraicNRLimit(0)
 	, useNodeCache(true)
 	, useSortedReasoning(true)
 	, isLikeGALEN(false)	// just in case Relevance part would be omited
 	, isLikeWINE(false)
 	, Consistent(true)
+	, Prepared(false)
 	, preprocTime(0)
 	, consistTime(0)
 {
@@ -67,6 +78,7 @@ TBox :: TBox ( const ifOptionSet* Options, const std::string& TopORoleName, cons
 	initTopBottom ();
 
 	setForbidUndefinedNames(false);
+	setDeadline(nullptr);
 }
 
 TBox :: ~TBox ( void )
@@ -87,15 +99,30 @@ TBox :: ~TBox ( void )
 	delete pTop;
 	delete pBottom;
 	delete pTemp;
-	delete pQuery;
+	for ( std::vector<TConcept*>::iterator p = QueryConcepts.begin(), p_end = QueryConcepts.end(); p != p_end; ++p )
+		delete *p;
 
 	// remove aux structures
+	delete pPrefetcher;
+	delete pSubBatch;
+	delete pTaskPool;
+	for ( auto& reasoner: PoolReasoners )
+		delete reasoner;
 	delete stdReasoner;
 	delete nomReasoner;
 	delete pTax;
 	delete pTaxCreator;
 }
 
+/// set given structure as a deadline of the queries
+void
+TBox :: setDeadline ( const TDeadline* deadline )
+{
+	// the loops check the deadline unconditionally, so keep a never-expiring one if none is given
+	static const TDeadline noDeadline;
+	pDeadline = deadline != nullptr ? deadline : &noDeadline;
+}
+
 /// get unique aux concept
 TConcept* TBox :: getAuxConcept ( DLTree* desc )
 {
@@ -169,6 +196,7 @@ void TBox :: initTopBottom ( void )
 	p = new TConcept("FaCT++.default");
 	p->setSystem();
 	pQuery = p;
+	QueryConcepts.push_back(p);
 }
 
 void TBox :: prepareReasoning ( void )
@@ -193,6 +221,7 @@ void TBox :: prepareReasoning ( void )
 
 	// init values for SAT tests -- either cache, or consistency check
 	DLHeap.setSatOrder();
+	Prepared = true;
 }
 
 /// prepare features for SAT(P), or SUB(P,Q) test
@@ -246,7 +275,9 @@ TBox :: performConsistencyCheck ( void )
 	TsProcTimer pt;
 	pt.Start();
 
-	buildSimpleCache();
+	// the check might be repeated after a timeout; the simple caches are there already
+	if ( DLHeap.getCache(bpBOTTOM) == nullptr )
+		buildSimpleCache();
 
 	TConcept* test = ( NCFeatures.hasSingletons() ? *i_begin() : nullptr );
 	prepareFeatures ( test, nullptr );
@@ -424,14 +455,18 @@ void TBox :: readConfig ( const ifOptionSet* Options )
 
 	// TBox options
 	addBoolOption(useCompletelyDefined);
+	addBoolOption(useIndividualGroups);
 	addBoolOption(dumpQuery);
 	addBoolOption(alwaysPreferEquals);
 	addBoolOption(useSpecialDomains);
 	// reasoner's options
 	addBoolOption(useSemanticBranching);
 	addBoolOption(useBackjumping);
+	addBoolOption(useNogoods);
+	addBoolOption(useLabelCache);
 	addBoolOption(useLazyBlocking);
 	addBoolOption(useAnywhereBlocking);
+	addBoolOption(useNominalSnapshot);
 
 	if ( Axioms.initAbsorptionFlags(Options->getText("absorptionFlags")) )
 		throw EFaCTPlusPlus ( "Incorrect absorption flags given" );
@@ -440,6 +475,18 @@ void TBox :: readConfig ( const ifOptionSet* Options )
 	if ( LLM.isWritable(llAlways) )
 		LL << "Init testTimeout = " << testTimeout << "\n";
 
+	nCacheThreads = (unsigned)Options->getInt("cacheThreads");
+	if ( LLM.isWritable(llAlways) )
+		LL << "Init cacheThreads = " << nCacheThreads << "\n";
+
+	nSubThreads = (unsigned)Options->getInt("subsumptionThreads");
+	if ( LLM.isWritable(llAlways) )
+		LL << "Init subsumptionThreads = " << nSubThreads << "\n";
+
+	algebraicNRLimit = (unsigned)Options->getInt("algebraicNRLimit");
+	if ( LLM.isWritable(llAlways) )
+		LL << "Init algebraicNRLimit = " << algebraicNRLimit << "\n";
+
 	PriorityMatrix.initPriorities ( Options->getText("IAOEFLG"), "IAOEFLG" );
 
 #ifdef RKG_USE_FAIRNESS
@@ -460,14 +507,20 @@ TBox :: createQueryConcept ( const DLTree* desc )
 {
 	fpp_assert ( desc != nullptr );
 
-	// make sure that an old query is gone
-	clearQueryConcept();
+	// old queries are kept in the DAG, so take the next unused query concept
+	if ( nQueryConcepts == QueryConcepts.size() )
+	{
+		TConcept* p = new TConcept("FaCT++.default");
+		p->setSystem();
+		QueryConcepts.push_back(p);
+	}
+	TConcept* query = QueryConcepts[nQueryConcepts++];
 	// create description
 //	std::cerr << "Create new temp concept with description =" << desc << "\n";
-	deleteTree ( makeNonPrimitive ( pQuery, clone(desc) ) );
-	pQuery->setIndex(nC-1);
+	deleteTree ( makeNonPrimitive ( query, clone(desc) ) );
+	query->setIndex(nC-1);
 
-	return pQuery;
+	return query;
 }
 
 /// preprocess query concept: put description into DAG
@@ -491,17 +544,17 @@ TBox :: preprocessQueryConcept ( TConcept* query )
 
 /// classify query concept
 void
-TBox :: classifyQueryConcept ( void )
+TBox :: classifyQueryConcept ( TConcept* query )
 {
 	// prepare told subsumers for classification; as it is non-primitive, it is not CD
-	pQuery->initToldSubsumers();
+	query->initToldSubsumers();
 
 	// setup taxonomy behaviour flags
 	fpp_assert ( pTax != nullptr );
 	pTaxCreator->setCompletelyDefined(false);	// non-primitive concept
 
 	// classify the concept
-	pTaxCreator->classifyEntry(pQuery);
+	pTaxCreator->classifyEntry(query);
 }
 
 /// knowledge exploration: build a model and return a link to the root
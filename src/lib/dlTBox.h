@@ -19,6 +19,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef DLTBOX_H
 #define DLTBOX_H
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <set>
@@ -37,9 +38,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tAxiomSet.h"
 #include "DataTypeCenter.h"
 #include "tProgressMonitor.h"
+#include "tDeadline.h"
 #include "tKBFlags.h"
 
 class DlSatTester;
+class CachePrefetcher;
+class TaskPool;
+class SubsumptionBatch;
 class Taxonomy;
 class DLConceptTaxonomy;
 class dumpInterface;
@@ -63,6 +68,7 @@ class TBox
 	friend class ReasoningKernel;
 	friend class TAxiom;	// FIXME!! while TConcept can't get rid of told cycles
 	friend class DLConceptTaxonomy;
+	friend class CachePrefetcher;
 
 public:		// type interface
 		/// vector of CONCEPT-like elements
@@ -150,6 +156,14 @@ protected:	// members
 	DlSatTester* stdReasoner;
 		/// reasoner for TBox-related queries with nominals
 	DlSatTester* nomReasoner;
+		/// pool of worker threads shared by all parallel tasks (if any)
+	TaskPool* pTaskPool;
+		/// private reasoners of the pool workers; one per worker
+	std::vector<DlSatTester*> PoolReasoners;
+		/// parallel cache builder (if any)
+	CachePrefetcher* pPrefetcher;
+		/// parallel subsumption tester (if any)
+	SubsumptionBatch* pSubBatch;
 		/// use this macro to do the same action with all available reasoners
 #	define REASONERS_DO(ACT) do {	\
 		nomReasoner->ACT;			\
@@ -157,6 +171,8 @@ protected:	// members
 
 		/// progress monitor
 	TProgressMonitor* pMonitor;
+		/// deadline of the current query
+	const TDeadline* pDeadline;
 
 		/// vectors for Completely defined, Non-CD and Non-primitive concepts
 	ConceptVector arrayCD, arrayNoCD, arrayNP;
@@ -194,6 +210,12 @@ protected:	// members
 	TConcept* pTemp;
 		/// temporary concept that represents query
 	TConcept* pQuery;
+		/// all the query concepts created so far; the 1st one is pQuery
+	std::vector<TConcept*> QueryConcepts;
+		/// number of query concepts used since the query part of the DAG was cleared
+	size_t nQueryConcepts;
+		/// number of times the query part of the DAG was cleared
+	unsigned int QueryEpoch;
 
 		/// all named concepts
 	ConceptCollection Concepts;
@@ -252,6 +274,10 @@ protected:	// members
 	ToDoPriorMatrix PriorityMatrix;
 		/// single SAT/SUB test timeout in milliseconds
 	unsigned long testTimeout;
+		/// number of threads used to build model caches in parallel; 0 means no parallel caching
+	unsigned int nCacheThreads;
+		/// number of threads used to test the sibling subsumptions in parallel; 0 means no parallel tests
+	unsigned int nSubThreads;
 
 	//---------------------------------------------------------------------------
 	// Reasoner's members: there are many reasoner classes, some members are shared
@@ -261,12 +287,20 @@ protected:	// members
 	bool useSemanticBranching;
 		/// flag for switching backjumping
 	bool useBackjumping;
+		/// flag for learning the nogoods from the clashes of the disjunction choices
+	bool useNogoods;
 		/// whether or not check blocking status as late as possible
 	bool useLazyBlocking;
 		/// flag for switching between Anywhere and Ancestor blockings
 	bool useAnywhereBlocking;
+		/// flag for re-using the complete model of the nominal cloud in every test
+	bool useNominalSnapshot;
+		/// the least N for which >= N R.C is represented by a single proxy successor; 0 means no proxies
+	unsigned int algebraicNRLimit;
 		/// flag to use caching during completion tree construction
 	bool useNodeCache;
+		/// flag to cache the satisfiability of the repeated node labels across the tests
+	bool useLabelCache;
 		/// how many nodes skip before block; work only with FAIRNESS
 	int nSkipBeforeBlock;
 
@@ -276,6 +310,8 @@ protected:	// members
 
 		/// flag for creating taxonomy
 	bool useCompletelyDefined;
+		/// flag to realise the individuals of the same shape once
+	bool useIndividualGroups;
 		/// flag for dumping TBox relevant to query
 	bool dumpQuery;
 		/// whether or not we need classification. Set up in checkQueryNames()
@@ -300,6 +336,8 @@ protected:	// members
 
 		/// whether KB is consistent
 	bool Consistent;
+		/// whether KB is preprocessed; the consistency check might be interrupted after that
+	bool Prepared;
 
 		/// time spend for preprocessing
 	float preprocTime;
@@ -722,6 +760,10 @@ protected:	// methods
 	}
 		/// classify all concepts from given COLLECTION with given CD value
 	void classifyConcepts ( const ConceptVector& collection, bool curCompletelyDefined, const char* type );
+		/// schedule the cache for C (or ~C if SUB) for the parallel construction
+	void schedulePrefetch ( const TConcept* C, bool sub );
+		/// build missing caches for the unclassified concepts in [BEGIN,END) in parallel; @return the end of the processed part
+	ConceptVector::const_iterator prefetchCaches ( ConceptVector::const_iterator begin, ConceptVector::const_iterator end );
 		/// classify single concept
 	void classifyEntry ( TConcept* entry );
 
@@ -1182,19 +1224,35 @@ public:
 	void setProgressMonitor ( TProgressMonitor* pMon ) { pMonitor = pMon; }
 		/// check that reasoning progress was cancelled by external application
 	bool isCancelled ( void ) const { return pMonitor != nullptr && pMonitor->isCancelled(); }
+		/// set given structure as a deadline of the queries
+	void setDeadline ( const TDeadline* deadline );
+		/// @return the deadline of the current query
+	const TDeadline& getDeadline ( void ) const { return *pDeadline; }
+		/// throw EFPPTimeout if the deadline of the current query has passed
+	void checkDeadline ( void ) const { pDeadline->check(); }
 		/// set verbose output (ie, default progress monitor, concept and role taxonomies) wrt given VALUE
 	void setVerboseOutput ( bool value ) { verboseOutput = value; }
 
-		/// create (and DAG-ify) query concept via its definition
+		/// create (and DAG-ify) query concept via its definition; the previous query concepts are kept
 	TConcept* createQueryConcept ( const DLTree* query );
 		/// preprocess query concept: put description into DAG
 	void preprocessQueryConcept ( TConcept* query );
-		/// classify query concept
-	void classifyQueryConcept ( void );
-		/// delete all query-related stuff
-	void clearQueryConcept ( void ) { DLHeap.removeQuery(); }
+		/// classify query concept QUERY
+	void classifyQueryConcept ( TConcept* query );
+		/// delete all query-related stuff; query concepts will be reused for the new queries
+	void clearQueryConcept ( void )
+	{
+		DLHeap.removeQuery();
+		nQueryConcepts = 0;
+		++QueryEpoch;
+	}
 		/// @return true if the concept in question is a query concept
-	bool isComplexQuery ( const TConcept* queryConcept ) const { return queryConcept == pQuery; }
+	bool isComplexQuery ( const TConcept* queryConcept ) const
+		{ return std::find ( QueryConcepts.begin(), QueryConcepts.begin()+nQueryConcepts, queryConcept ) != QueryConcepts.begin()+nQueryConcepts; }
+		/// @return number of query concepts created since the query part of the DAG was cleared
+	size_t getNQueryConcepts ( void ) const { return nQueryConcepts; }
+		/// @return the number of the query DAG epoch; query concepts of the previous epochs are no longer valid
+	unsigned int getQueryEpoch ( void ) const { return QueryEpoch; }
 
 //-----------------------------------------------------------------------------
 //--		public reasoning interface
@@ -1202,6 +1260,8 @@ public:
 
 		/// get status flag
 	KBStatus getStatus ( void ) const { return Status; }
+		/// @return true iff KB is preprocessed, so only the consistency check (if any) is left to do
+	bool isPrepared ( void ) const { return Prepared; }
 		/// set consistency flag
 	void setConsistency ( bool val )
 	{
@@ -1213,7 +1273,9 @@ public:
 	{
 		if ( Status < kbCChecked )
 		{
-			prepareReasoning();
+			// the preprocessing is done once, even if the check itself was interrupted
+			if ( !Prepared )
+				prepareReasoning();
 			if ( Status < kbCChecked && Consistent )	// we can detect inconsistency during preprocessing
 				setConsistency(performConsistencyCheck());
 		}
@@ -1232,6 +1294,18 @@ public:
 
 		/// fills cache entry for given concept; SUB means that the concept is on the right side of a subsumption test
 	const modelCacheInterface* initCache ( const TConcept* pConcept, bool sub = false );
+		/// @return the pool of worker threads; it exists iff any parallel feature is on
+	TaskPool& getTaskPool ( void ) { return *pTaskPool; }
+		/// @return the private reasoner of the pool worker I
+	DlSatTester* getPoolReasoner ( unsigned int i ) const { return PoolReasoners[i]; }
+		/// @return true iff model caches could be built in parallel
+	bool usePrefetch ( void ) const { return pPrefetcher != nullptr; }
+		/// @return true iff subsumption tests could be made in parallel
+	bool useParallelSub ( void ) const { return pSubBatch != nullptr; }
+		/// schedule the test P [= Q for the parallel run, set its INDEX in the batch; @return false iff the test can't be made in parallel
+	bool scheduleSub ( const TConcept* p, const TConcept* q, size_t& index );
+		/// @return the batch of the parallel subsumption tests
+	SubsumptionBatch& getSubBatch ( void ) { return *pSubBatch; }
 
 		/// build a completion tree for a concept C (no caching as it breaks the idea of KE). @return the root node
 	const DlCompletionTree* buildCompletionTree ( const TConcept* C );
@@ -0,0 +1,86 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TACTIVITYSCORES_H
+#define TACTIVITYSCORES_H
+
+#include <vector>
+
+#include "BiPointer.h"
+
+/**
+ * Activity scores of the concepts used as disjuncts. Every time a clash is
+ * caused by a disjunction choice, the score of the chosen disjunct is bumped;
+ * the older bumps decay exponentially (as in VSIDS of SAT solvers), so the
+ * scores reflect the recent clashes. The scores are kept between the tests.
+ */
+class TActivityScores
+{
+protected:	// members
+		/// scores of the positive and negative version of every DAG vertex
+	std::vector<double> Score;
+		/// current value of the bump
+	double Inc;
+		/// decay factor of the scores
+	double Decay;
+
+protected:	// methods
+		/// @return index of the score of the concept C
+	static size_t index ( BipolarPointer C ) { return 2*getValue(C) + ( isNegative(C) ? 1 : 0 ); }
+		/// scale all the scores down to prevent the overflow
+	void rescale ( void )
+	{
+		for ( auto& s: Score )
+			s *= 1e-100;
+		Inc *= 1e-100;
+	}
+
+public:		// interface
+		/// init c'tor
+	TActivityScores ( double decay = 0.95 ) : Inc(1.0), Decay(decay) {}
+
+		/// @return the score of the concept C
+	double get ( BipolarPointer C ) const
+	{
+		size_t i = index(C);
+		return i < Score.size() ? Score[i] : 0.0;
+	}
+		/// increase the score of the concept C by the current bump
+	void bump ( BipolarPointer C )
+	{
+		size_t i = index(C);
+		if ( i >= Score.size() )
+			Score.resize ( i+1, 0.0 );
+		if ( ( Score[i] += Inc ) > 1e100 )
+			rescale();
+	}
+		/// decay all the scores; implemented by increasing the future bumps
+	void decay ( void )
+	{
+		if ( ( Inc /= Decay ) > 1e100 )
+			rescale();
+	}
+		/// forget all the scores
+	void clear ( void )
+	{
+		Score.clear();
+		Inc = 1.0;
+	}
+}; // TActivityScores
+
+#endif
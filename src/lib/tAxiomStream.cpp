@@ -0,0 +1,511 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "tAxiomStream.h"
+#include "eFPPSaveLoad.h"
+
+/// signature of the binary axiom stream
+static const char AxiomStreamMagic[] = "FPPAXS";
+/// version of the binary axiom stream format
+static const char AxiomStreamVersion = 1;
+
+//-------------------------------------------------------------
+// TAxiomStreamWriter implementation
+//-------------------------------------------------------------
+
+void
+TAxiomStreamWriter :: ExpressionWriter :: visit ( const TDLDataTypeRestriction& expr )
+{
+	unsigned int host = id(expr.getExpr());
+	std::vector<unsigned int> facets;
+	for ( const auto& facet: expr )
+		facets.push_back(id(facet));
+	Writer.putTag(asDTypeRestriction);
+	Writer.putNum(host);
+	Writer.putArgs(facets);
+}
+
+void
+TAxiomStreamWriter :: ExpressionWriter :: visit ( const TDLDataValue& expr )
+{
+	// values are kept by the basic datatypes
+	unsigned int type = id(getBasicDataType(const_cast<TDLDataTypeExpression*>(expr.getExpr())));
+	Writer.putTag(asDValue);
+	Writer.putNum(type);
+	Writer.putString(expr.getName());
+}
+
+TAxiomStreamWriter :: TAxiomStreamWriter ( std::ostream& o_, const TExpressionManager& em )
+	: o(o_)
+	, EWriter(*this,em)
+{
+	o.write ( AxiomStreamMagic, sizeof(AxiomStreamMagic)-1 );
+	o.put(AxiomStreamVersion);
+}
+
+void
+TAxiomStreamWriter :: putString ( const char* str )
+{
+	size_t len = strlen(str);
+	putNum(len);
+	o.write ( str, len );
+}
+
+void
+TAxiomStreamWriter :: write ( const TOntology& ontology )
+{
+	const AxiomVec& axioms = ontology.getAxioms();
+	for ( AxiomVec::const_iterator p = axioms.begin(), p_end = axioms.end(); p != p_end; ++p )
+		if ( (*p)->isUsed() )
+			write(*p);
+}
+
+//-------------------------------------------------------------
+// TAxiomStreamReader implementation
+//-------------------------------------------------------------
+
+TAxiomStreamReader :: TAxiomStreamReader ( std::istream& i_, TOntology& ontology )
+	: i(i_)
+	, Buffer(1<<16)
+	, Pos(Buffer.data())
+	, End(Buffer.data())
+	, Ontology(ontology)
+	, EManager(*ontology.getExpressionManager())
+{
+	for ( size_t k = 0; k < sizeof(AxiomStreamMagic)-1; ++k )
+		if ( getByte() != AxiomStreamMagic[k] )
+			error("not an axiom stream");
+	if ( getByte() != AxiomStreamVersion )
+		error("unsupported version");
+}
+
+bool
+TAxiomStreamReader :: fill ( void )
+{
+	i.read ( Buffer.data(), static_cast<std::streamsize>(Buffer.size()) );
+	Pos = Buffer.data();
+	End = Pos + i.gcount();
+	return Pos != End;
+}
+
+const std::string&
+TAxiomStreamReader :: getString ( void )
+{
+	std::uint64_t len = getNum();
+	Str.clear();
+	while ( len > 0 )
+	{
+		if ( Pos == End && !fill() )
+			error("unexpected end of stream");
+		size_t n = std::min ( static_cast<size_t>(End-Pos), static_cast<size_t>(len) );
+		Str.append ( Pos, n );
+		Pos += n;
+		len -= n;
+	}
+	return Str;
+}
+
+void
+TAxiomStreamReader :: error ( const char* reason )
+{
+	throw EFPPSaveLoad ( std::string("Malformed axiom stream: ") + reason );
+}
+
+void
+TAxiomStreamReader :: readExpression ( int tag )
+{
+	const TDLExpression* ret = nullptr;
+	Kind kind = kConcept;
+
+	switch ( tag )
+	{
+	// concept expressions
+	case asCTop:
+		ret = EManager.Top();
+		break;
+	case asCBottom:
+		ret = EManager.Bottom();
+		break;
+	case asCName:
+		ret = EManager.Concept(getString());
+		break;
+	case asCNot:
+		ret = EManager.Not(get<TDLConceptExpression>(kConcept));
+		break;
+	case asCAnd:
+		getArgList(kConcept);
+		ret = EManager.And();
+		break;
+	case asCOr:
+		getArgList(kConcept);
+		ret = EManager.Or();
+		break;
+	case asCOneOf:
+		getArgList(kIndividual);
+		ret = EManager.OneOf();
+		break;
+	case asCSelf:
+		ret = EManager.SelfReference(get<TDLObjectRoleExpression>(kORole));
+		break;
+	case asCValue:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		ret = EManager.Value ( R, get<TDLIndividualExpression>(kIndividual) );
+		break;
+	}
+	case asCExists:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		ret = EManager.Exists ( R, get<TDLConceptExpression>(kConcept) );
+		break;
+	}
+	case asCForall:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		ret = EManager.Forall ( R, get<TDLConceptExpression>(kConcept) );
+		break;
+	}
+	case asCMinCardinality:
+	case asCMaxCardinality:
+	case asCExactCardinality:
+	{
+		unsigned int n = getCardinality();
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		auto C = get<TDLConceptExpression>(kConcept);
+		ret = tag == asCMinCardinality ? EManager.MinCardinality ( n, R, C ) :
+			  tag == asCMaxCardinality ? EManager.MaxCardinality ( n, R, C ) :
+										 EManager.Cardinality ( n, R, C );
+		break;
+	}
+	case asCDataValue:
+	{
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		ret = EManager.Value ( A, get<TDLDataValue>(kDataValue) );
+		break;
+	}
+	case asCDataExists:
+	{
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		ret = EManager.Exists ( A, get<TDLDataExpression>(kData) );
+		break;
+	}
+	case asCDataForall:
+	{
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		ret = EManager.Forall ( A, get<TDLDataExpression>(kData) );
+		break;
+	}
+	case asCDataMinCardinality:
+	case asCDataMaxCardinality:
+	case asCDataExactCardinality:
+	{
+		unsigned int n = getCardinality();
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		auto E = get<TDLDataExpression>(kData);
+		ret = tag == asCDataMinCardinality ? EManager.MinCardinality ( n, A, E ) :
+			  tag == asCDataMaxCardinality ? EManager.MaxCardinality ( n, A, E ) :
+											 EManager.Cardinality ( n, A, E );
+		break;
+	}
+
+	// individual expressions
+	case asIName:
+		ret = EManager.Individual(getString());
+		kind = kIndividual;
+		break;
+
+	// object role expressions
+	case asORTop:
+		ret = EManager.ObjectRoleTop();
+		kind = kORole;
+		break;
+	case asORBottom:
+		ret = EManager.ObjectRoleBottom();
+		kind = kORole;
+		break;
+	case asORName:
+		ret = EManager.ObjectRole(getString());
+		kind = kORole;
+		break;
+	case asORInverse:
+		ret = EManager.Inverse(get<TDLObjectRoleExpression>(kORole));
+		kind = kORole;
+		break;
+	case asORChain:
+		getArgList(kORole);
+		ret = EManager.Compose();
+		kind = kORoleComplex;
+		break;
+	case asORProjectionFrom:
+	case asORProjectionInto:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		auto C = get<TDLConceptExpression>(kConcept);
+		ret = tag == asORProjectionFrom ? EManager.ProjectFrom ( R, C ) : EManager.ProjectInto ( R, C );
+		kind = kORoleComplex;
+		break;
+	}
+
+	// data role expressions
+	case asDRTop:
+		ret = EManager.DataRoleTop();
+		kind = kDRole;
+		break;
+	case asDRBottom:
+		ret = EManager.DataRoleBottom();
+		kind = kDRole;
+		break;
+	case asDRName:
+		ret = EManager.DataRole(getString());
+		kind = kDRole;
+		break;
+
+	// data expressions
+	case asDTop:
+		ret = EManager.DataTop();
+		kind = kData;
+		break;
+	case asDBottom:
+		ret = EManager.DataBottom();
+		kind = kData;
+		break;
+	case asDTypeName:
+		ret = EManager.DataType(getString());
+		kind = kDataTypeName;
+		break;
+	case asDTypeRestriction:
+	{
+		TDLDataTypeExpression* type = const_cast<TDLDataTypeName*>(get<TDLDataTypeName>(kDataTypeName));
+		std::uint64_t n = getNum();
+		if ( n == 0 )
+			error("datatype restriction without facets");
+		for ( ; n > 0; --n )
+			type = EManager.RestrictedType ( type, get<TDLFacetExpression>(kFacet) );
+		ret = type;
+		kind = kDataType;
+		break;
+	}
+	case asDValue:
+	{
+		TDLDataTypeExpression* type = const_cast<TDLDataTypeName*>(get<TDLDataTypeName>(kDataTypeName));
+		ret = EManager.DataValue ( getString(), type );
+		kind = kDataValue;
+		break;
+	}
+	case asDNot:
+		ret = EManager.DataNot(get<TDLDataExpression>(kData));
+		kind = kData;
+		break;
+	case asDAnd:
+		getArgList(kData);
+		ret = EManager.DataAnd();
+		kind = kData;
+		break;
+	case asDOr:
+		getArgList(kData);
+		ret = EManager.DataOr();
+		kind = kData;
+		break;
+	case asDOneOf:
+		getArgList(kDataValue);
+		ret = EManager.DataOneOf();
+		kind = kData;
+		break;
+
+	// facets
+	case asFMinInclusive:
+		ret = EManager.FacetMinInclusive(get<TDLDataValue>(kDataValue));
+		kind = kFacet;
+		break;
+	case asFMinExclusive:
+		ret = EManager.FacetMinExclusive(get<TDLDataValue>(kDataValue));
+		kind = kFacet;
+		break;
+	case asFMaxInclusive:
+		ret = EManager.FacetMaxInclusive(get<TDLDataValue>(kDataValue));
+		kind = kFacet;
+		break;
+	case asFMaxExclusive:
+		ret = EManager.FacetMaxExclusive(get<TDLDataValue>(kDataValue));
+		kind = kFacet;
+		break;
+
+	default:
+		error("unknown expression tag");
+	}
+
+	Exprs.push_back(Entry{ret,kind});
+}
+
+TDLAxiom*
+TAxiomStreamReader :: readAxiom ( int tag )
+{
+	switch ( tag )
+	{
+	case asDeclaration:
+		return new TDLAxiomDeclaration(getExpr(kAny));
+	case asEquivalentConcepts:
+		getArgs(kConcept);
+		return new TDLAxiomEquivalentConcepts(Args);
+	case asDisjointConcepts:
+		getArgs(kConcept);
+		return new TDLAxiomDisjointConcepts(Args);
+	case asDisjointUnion:
+	{
+		auto C = get<TDLConceptExpression>(kConcept);
+		getArgs(kConcept);
+		return new TDLAxiomDisjointUnion ( C, Args );
+	}
+	case asEquivalentORoles:
+		getArgs(kORole);
+		return new TDLAxiomEquivalentORoles(Args);
+	case asEquivalentDRoles:
+		getArgs(kDRole);
+		return new TDLAxiomEquivalentDRoles(Args);
+	case asDisjointORoles:
+		getArgs(kORole);
+		return new TDLAxiomDisjointORoles(Args);
+	case asDisjointDRoles:
+		getArgs(kDRole);
+		return new TDLAxiomDisjointDRoles(Args);
+	case asSameIndividuals:
+		getArgs(kIndividual);
+		return new TDLAxiomSameIndividuals(Args);
+	case asDifferentIndividuals:
+		getArgs(kIndividual);
+		return new TDLAxiomDifferentIndividuals(Args);
+	case asFairnessConstraint:
+		getArgs(kConcept);
+		return new TDLAxiomFairnessConstraint(Args);
+
+	case asRoleInverse:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		return new TDLAxiomRoleInverse ( R, get<TDLObjectRoleExpression>(kORole) );
+	}
+	case asORoleSubsumption:
+	{
+		auto R = get<TDLObjectRoleComplexExpression>(kORoleComplex);
+		return new TDLAxiomORoleSubsumption ( R, get<TDLObjectRoleExpression>(kORole) );
+	}
+	case asDRoleSubsumption:
+	{
+		auto R = get<TDLDataRoleExpression>(kDRole);
+		return new TDLAxiomDRoleSubsumption ( R, get<TDLDataRoleExpression>(kDRole) );
+	}
+	case asORoleDomain:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		return new TDLAxiomORoleDomain ( R, get<TDLConceptExpression>(kConcept) );
+	}
+	case asDRoleDomain:
+	{
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		return new TDLAxiomDRoleDomain ( A, get<TDLConceptExpression>(kConcept) );
+	}
+	case asORoleRange:
+	{
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		return new TDLAxiomORoleRange ( R, get<TDLConceptExpression>(kConcept) );
+	}
+	case asDRoleRange:
+	{
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		return new TDLAxiomDRoleRange ( A, get<TDLDataExpression>(kData) );
+	}
+	case asRoleTransitive:
+		return new TDLAxiomRoleTransitive(get<TDLObjectRoleExpression>(kORole));
+	case asRoleReflexive:
+		return new TDLAxiomRoleReflexive(get<TDLObjectRoleExpression>(kORole));
+	case asRoleIrreflexive:
+		return new TDLAxiomRoleIrreflexive(get<TDLObjectRoleExpression>(kORole));
+	case asRoleSymmetric:
+		return new TDLAxiomRoleSymmetric(get<TDLObjectRoleExpression>(kORole));
+	case asRoleAsymmetric:
+		return new TDLAxiomRoleAsymmetric(get<TDLObjectRoleExpression>(kORole));
+	case asORoleFunctional:
+		return new TDLAxiomORoleFunctional(get<TDLObjectRoleExpression>(kORole));
+	case asDRoleFunctional:
+		return new TDLAxiomDRoleFunctional(get<TDLDataRoleExpression>(kDRole));
+	case asRoleInverseFunctional:
+		return new TDLAxiomRoleInverseFunctional(get<TDLObjectRoleExpression>(kORole));
+
+	case asConceptInclusion:
+	{
+		auto C = get<TDLConceptExpression>(kConcept);
+		return new TDLAxiomConceptInclusion ( C, get<TDLConceptExpression>(kConcept) );
+	}
+	case asInstanceOf:
+	{
+		auto I = get<TDLIndividualExpression>(kIndividual);
+		return new TDLAxiomInstanceOf ( I, get<TDLConceptExpression>(kConcept) );
+	}
+	case asRelatedTo:
+	case asRelatedToNot:
+	{
+		auto I = get<TDLIndividualExpression>(kIndividual);
+		auto R = get<TDLObjectRoleExpression>(kORole);
+		auto J = get<TDLIndividualExpression>(kIndividual);
+		if ( tag == asRelatedTo )
+			return new TDLAxiomRelatedTo ( I, R, J );
+		return new TDLAxiomRelatedToNot ( I, R, J );
+	}
+	case asValueOf:
+	case asValueOfNot:
+	{
+		auto I = get<TDLIndividualExpression>(kIndividual);
+		auto A = get<TDLDataRoleExpression>(kDRole);
+		auto V = get<TDLDataValue>(kDataValue);
+		if ( tag == asValueOf )
+			return new TDLAxiomValueOf ( I, A, V );
+		return new TDLAxiomValueOfNot ( I, A, V );
+	}
+
+	default:
+		error("unknown axiom tag");
+		return nullptr;
+	}
+}
+
+size_t
+TAxiomStreamReader :: read ( void )
+{
+	// a malformed stream should leave the ontology intact, so add the axioms only after the whole stream is read
+	std::vector<TDLAxiom*> axioms;
+	try
+	{
+		for ( int tag = getByte(); tag != EOF; tag = getByte() )
+			if ( tag < asFirstAxiom )
+				readExpression(tag);
+			else
+				axioms.push_back(readAxiom(tag));
+	}
+	catch (...)
+	{
+		for ( auto& axiom: axioms )
+			delete axiom;
+		throw;
+	}
+
+	for ( auto& axiom: axioms )
+		Ontology.add(axiom);
+	return axioms.size();
+}
@@ -0,0 +1,540 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TAXIOMSTREAM_H
+#define TAXIOMSTREAM_H
+
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "tOntology.h"
+
+/*
+ * Binary axiom stream is a header followed by a sequence of records. Every
+ * record starts with a tag byte. Expression records define the expressions
+ * bottom-up: each one gets the next expression id and refers to its arguments
+ * by their ids; names are written only once. Axiom records refer to the
+ * expressions by ids as well. Numbers are written as little-endian base-128
+ * varints, strings as a length followed by the characters.
+ */
+
+/// tags of the records in the binary axiom stream
+enum AxiomStreamTag
+{
+	// concept expressions
+	asCTop,
+	asCBottom,
+	asCName,
+	asCNot,
+	asCAnd,
+	asCOr,
+	asCOneOf,
+	asCSelf,
+	asCValue,
+	asCExists,
+	asCForall,
+	asCMinCardinality,
+	asCMaxCardinality,
+	asCExactCardinality,
+	asCDataValue,
+	asCDataExists,
+	asCDataForall,
+	asCDataMinCardinality,
+	asCDataMaxCardinality,
+	asCDataExactCardinality,
+
+	// individual expressions
+	asIName,
+
+	// object role expressions
+	asORTop,
+	asORBottom,
+	asORName,
+	asORInverse,
+	asORChain,
+	asORProjectionFrom,
+	asORProjectionInto,
+
+	// data role expressions
+	asDRTop,
+	asDRBottom,
+	asDRName,
+
+	// data expressions
+	asDTop,
+	asDBottom,
+	asDTypeName,
+	asDTypeRestriction,
+	asDValue,
+	asDNot,
+	asDAnd,
+	asDOr,
+	asDOneOf,
+
+	// facets
+	asFMinInclusive,
+	asFMinExclusive,
+	asFMaxInclusive,
+	asFMaxExclusive,
+
+	// axioms
+	asFirstAxiom = 64,
+	asDeclaration = asFirstAxiom,
+	asEquivalentConcepts,
+	asDisjointConcepts,
+	asDisjointUnion,
+	asEquivalentORoles,
+	asEquivalentDRoles,
+	asDisjointORoles,
+	asDisjointDRoles,
+	asSameIndividuals,
+	asDifferentIndividuals,
+	asFairnessConstraint,
+	asRoleInverse,
+	asORoleSubsumption,
+	asDRoleSubsumption,
+	asORoleDomain,
+	asDRoleDomain,
+	asORoleRange,
+	asDRoleRange,
+	asRoleTransitive,
+	asRoleReflexive,
+	asRoleIrreflexive,
+	asRoleSymmetric,
+	asRoleAsymmetric,
+	asORoleFunctional,
+	asDRoleFunctional,
+	asRoleInverseFunctional,
+	asConceptInclusion,
+	asInstanceOf,
+	asRelatedTo,
+	asRelatedToNot,
+	asValueOf,
+	asValueOfNot,
+	asLastTag
+}; // AxiomStreamTag
+
+/// writer of the axioms to a binary axiom stream
+class TAxiomStreamWriter: public DLAxiomVisitor
+{
+protected:	// types
+		/// writer of the expressions; every expression is written once
+	class ExpressionWriter: public DLExpressionVisitor
+	{
+	protected:	// members
+			/// writer that owns the stream
+		TAxiomStreamWriter& Writer;
+			/// expression manager of the written axioms
+		const TExpressionManager& EManager;
+			/// ids of the written expressions
+		std::unordered_map<const TDLExpression*, unsigned int> Ids;
+
+	protected:	// methods
+			/// write a record with TAG and one argument
+		void record ( AxiomStreamTag tag, const TDLExpression* arg )
+		{
+			unsigned int a = id(arg);
+			Writer.putTag(tag);
+			Writer.putNum(a);
+		}
+			/// write a record with TAG and two arguments
+		void record ( AxiomStreamTag tag, const TDLExpression* arg1, const TDLExpression* arg2 )
+		{
+			unsigned int a1 = id(arg1), a2 = id(arg2);
+			Writer.putTag(tag);
+			Writer.putNum(a1);
+			Writer.putNum(a2);
+		}
+			/// write a record with TAG, number N and two arguments
+		void record ( AxiomStreamTag tag, unsigned int n, const TDLExpression* arg1, const TDLExpression* arg2 )
+		{
+			unsigned int a1 = id(arg1), a2 = id(arg2);
+			Writer.putTag(tag);
+			Writer.putNum(n);
+			Writer.putNum(a1);
+			Writer.putNum(a2);
+		}
+			/// write a record with TAG and a NAME
+		void record ( AxiomStreamTag tag, const char* name ) { Writer.putTag(tag); Writer.putString(name); }
+			/// write a record with TAG and all the arguments of EXPR
+		template<class Argument>
+		void record ( AxiomStreamTag tag, const TDLNAryExpression<Argument>& expr )
+		{
+			// NB: arguments could be n-ary expressions as well, so the ids are kept locally
+			std::vector<unsigned int> args;
+			for ( const auto& arg: expr )
+				args.push_back(id(arg));
+			Writer.putTag(tag);
+			Writer.putArgs(args);
+		}
+
+	public:		// interface
+			/// init c'tor
+		ExpressionWriter ( TAxiomStreamWriter& writer, const TExpressionManager& em ) : Writer(writer), EManager(em) {}
+			/// empty d'tor
+		virtual ~ExpressionWriter ( void ) {}
+
+			/// @return id of an expression EXPR; write it if necessary
+		unsigned int id ( const TDLExpression* expr )
+		{
+			auto p = Ids.find(expr);
+			if ( p != Ids.end() )
+				return p->second;
+			expr->accept(*this);
+			unsigned int ret = static_cast<unsigned int>(Ids.size());
+			Ids[expr] = ret;
+			return ret;
+		}
+
+	public:		// visitor interface
+		// concept expressions
+		virtual void visit ( const TDLConceptTop& ) { Writer.putTag(asCTop); }
+		virtual void visit ( const TDLConceptBottom& ) { Writer.putTag(asCBottom); }
+		virtual void visit ( const TDLConceptName& expr ) { record ( asCName, expr.getName() ); }
+		virtual void visit ( const TDLConceptNot& expr ) { record ( asCNot, expr.getC() ); }
+		virtual void visit ( const TDLConceptAnd& expr ) { record ( asCAnd, expr ); }
+		virtual void visit ( const TDLConceptOr& expr ) { record ( asCOr, expr ); }
+		virtual void visit ( const TDLConceptOneOf& expr ) { record ( asCOneOf, expr ); }
+		virtual void visit ( const TDLConceptObjectSelf& expr ) { record ( asCSelf, expr.getOR() ); }
+		virtual void visit ( const TDLConceptObjectValue& expr ) { record ( asCValue, expr.getOR(), expr.getI() ); }
+		virtual void visit ( const TDLConceptObjectExists& expr ) { record ( asCExists, expr.getOR(), expr.getC() ); }
+		virtual void visit ( const TDLConceptObjectForall& expr ) { record ( asCForall, expr.getOR(), expr.getC() ); }
+		virtual void visit ( const TDLConceptObjectMinCardinality& expr )
+			{ record ( asCMinCardinality, expr.getNumber(), expr.getOR(), expr.getC() ); }
+		virtual void visit ( const TDLConceptObjectMaxCardinality& expr )
+			{ record ( asCMaxCardinality, expr.getNumber(), expr.getOR(), expr.getC() ); }
+		virtual void visit ( const TDLConceptObjectExactCardinality& expr )
+			{ record ( asCExactCardinality, expr.getNumber(), expr.getOR(), expr.getC() ); }
+		virtual void visit ( const TDLConceptDataValue& expr ) { record ( asCDataValue, expr.getDR(), expr.getExpr() ); }
+		virtual void visit ( const TDLConceptDataExists& expr ) { record ( asCDataExists, expr.getDR(), expr.getExpr() ); }
+		virtual void visit ( const TDLConceptDataForall& expr ) { record ( asCDataForall, expr.getDR(), expr.getExpr() ); }
+		virtual void visit ( const TDLConceptDataMinCardinality& expr )
+			{ record ( asCDataMinCardinality, expr.getNumber(), expr.getDR(), expr.getExpr() ); }
+		virtual void visit ( const TDLConceptDataMaxCardinality& expr )
+			{ record ( asCDataMaxCardinality, expr.getNumber(), expr.getDR(), expr.getExpr() ); }
+		virtual void visit ( const TDLConceptDataExactCardinality& expr )
+			{ record ( asCDataExactCardinality, expr.getNumber(), expr.getDR(), expr.getExpr() ); }
+
+		// individual expressions
+		virtual void visit ( const TDLIndividualName& expr ) { record ( asIName, expr.getName() ); }
+
+		// object role expressions; universal and empty roles are names in the expression manager
+		virtual void visit ( const TDLObjectRoleTop& ) { Writer.putTag(asORTop); }
+		virtual void visit ( const TDLObjectRoleBottom& ) { Writer.putTag(asORBottom); }
+		virtual void visit ( const TDLObjectRoleName& expr )
+		{
+			if ( EManager.isUniversalRole(&expr) )
+				Writer.putTag(asORTop);
+			else if ( EManager.isEmptyRole(&expr) )
+				Writer.putTag(asORBottom);
+			else
+				record ( asORName, expr.getName() );
+		}
+		virtual void visit ( const TDLObjectRoleInverse& expr ) { record ( asORInverse, expr.getOR() ); }
+		virtual void visit ( const TDLObjectRoleChain& expr ) { record ( asORChain, expr ); }
+		virtual void visit ( const TDLObjectRoleProjectionFrom& expr ) { record ( asORProjectionFrom, expr.getOR(), expr.getC() ); }
+		virtual void visit ( const TDLObjectRoleProjectionInto& expr ) { record ( asORProjectionInto, expr.getOR(), expr.getC() ); }
+
+		// data role expressions
+		virtual void visit ( const TDLDataRoleTop& ) { Writer.putTag(asDRTop); }
+		virtual void visit ( const TDLDataRoleBottom& ) { Writer.putTag(asDRBottom); }
+		virtual void visit ( const TDLDataRoleName& expr )
+		{
+			if ( EManager.isUniversalRole(&expr) )
+				Writer.putTag(asDRTop);
+			else if ( EManager.isEmptyRole(&expr) )
+				Writer.putTag(asDRBottom);
+			else
+				record ( asDRName, expr.getName() );
+		}
+
+		// data expressions
+		virtual void visit ( const TDLDataTop& ) { Writer.putTag(asDTop); }
+		virtual void visit ( const TDLDataBottom& ) { Writer.putTag(asDBottom); }
+		virtual void visit ( const TDLDataTypeName& expr ) { record ( asDTypeName, expr.getName() ); }
+		virtual void visit ( const TDLDataTypeRestriction& expr );
+		virtual void visit ( const TDLDataValue& expr );
+		virtual void visit ( const TDLDataNot& expr ) { record ( asDNot, expr.getExpr() ); }
+		virtual void visit ( const TDLDataAnd& expr ) { record ( asDAnd, expr ); }
+		virtual void visit ( const TDLDataOr& expr ) { record ( asDOr, expr ); }
+		virtual void visit ( const TDLDataOneOf& expr ) { record ( asDOneOf, expr ); }
+
+		// facets
+		virtual void visit ( const TDLFacetMinInclusive& expr ) { record ( asFMinInclusive, expr.getExpr() ); }
+		virtual void visit ( const TDLFacetMinExclusive& expr ) { record ( asFMinExclusive, expr.getExpr() ); }
+		virtual void visit ( const TDLFacetMaxInclusive& expr ) { record ( asFMaxInclusive, expr.getExpr() ); }
+		virtual void visit ( const TDLFacetMaxExclusive& expr ) { record ( asFMaxExclusive, expr.getExpr() ); }
+	}; // ExpressionWriter
+
+protected:	// members
+		/// output stream
+	std::ostream& o;
+		/// writer of the expressions
+	ExpressionWriter EWriter;
+		/// ids of the arguments of the current axiom
+	std::vector<unsigned int> Args;
+
+protected:	// methods
+		/// write a TAG
+	void putTag ( AxiomStreamTag tag ) { o.put(static_cast<char>(tag)); }
+		/// write a number N as a varint
+	void putNum ( std::uint64_t n )
+	{
+		for ( ; n >= 0x80; n >>= 7 )
+			o.put(static_cast<char>((n & 0x7F) | 0x80));
+		o.put(static_cast<char>(n));
+	}
+		/// write a string STR
+	void putString ( const char* str );
+		/// write the number of arguments and all the arguments
+	void putArgs ( const std::vector<unsigned int>& args )
+	{
+		putNum(args.size());
+		for ( auto arg: args )
+			putNum(arg);
+	}
+		/// write an axiom record with TAG and the arguments ARGS
+	template<typename... Arguments>
+	void axiom ( AxiomStreamTag tag, const Arguments*... args )
+	{
+		unsigned int ids[] = { EWriter.id(args)... };
+		putTag(tag);
+		for ( auto id: ids )
+			putNum(id);
+	}
+		/// write an axiom record with TAG, the argument FIRST (if any) and all the arguments of EXPR
+	template<class Argument>
+	void axiom ( AxiomStreamTag tag, const TDLExpression* first, const TDLNAryExpression<Argument>& expr )
+	{
+		unsigned int firstId = first == nullptr ? 0 : EWriter.id(first);
+		Args.clear();
+		for ( const auto& arg: expr )
+			Args.push_back(EWriter.id(arg));
+		putTag(tag);
+		if ( first != nullptr )
+			putNum(firstId);
+		putArgs(Args);
+	}
+		/// write an axiom record with TAG and all the arguments of EXPR
+	template<class Argument>
+	void axiom ( AxiomStreamTag tag, const TDLNAryExpression<Argument>& expr ) { axiom ( tag, nullptr, expr ); }
+
+public:		// visitor interface
+	virtual void visit ( const TDLAxiomDeclaration& ax ) { axiom ( asDeclaration, ax.getDeclaration() ); }
+	virtual void visit ( const TDLAxiomEquivalentConcepts& ax ) { axiom ( asEquivalentConcepts, ax ); }
+	virtual void visit ( const TDLAxiomDisjointConcepts& ax ) { axiom ( asDisjointConcepts, ax ); }
+	virtual void visit ( const TDLAxiomDisjointUnion& ax ) { axiom ( asDisjointUnion, ax.getC(), ax ); }
+	virtual void visit ( const TDLAxiomEquivalentORoles& ax ) { axiom ( asEquivalentORoles, ax ); }
+	virtual void visit ( const TDLAxiomEquivalentDRoles& ax ) { axiom ( asEquivalentDRoles, ax ); }
+	virtual void visit ( const TDLAxiomDisjointORoles& ax ) { axiom ( asDisjointORoles, ax ); }
+	virtual void visit ( const TDLAxiomDisjointDRoles& ax ) { axiom ( asDisjointDRoles, ax ); }
+	virtual void visit ( const TDLAxiomSameIndividuals& ax ) { axiom ( asSameIndividuals, ax ); }
+	virtual void visit ( const TDLAxiomDifferentIndividuals& ax ) { axiom ( asDifferentIndividuals, ax ); }
+	virtual void visit ( const TDLAxiomFairnessConstraint& ax ) { axiom ( asFairnessConstraint, ax ); }
+
+	virtual void visit ( const TDLAxiomRoleInverse& ax ) { axiom ( asRoleInverse, ax.getRole(), ax.getInvRole() ); }
+	virtual void visit ( const TDLAxiomORoleSubsumption& ax ) { axiom ( asORoleSubsumption, ax.getSubRole(), ax.getRole() ); }
+	virtual void visit ( const TDLAxiomDRoleSubsumption& ax ) { axiom ( asDRoleSubsumption, ax.getSubRole(), ax.getRole() ); }
+	virtual void visit ( const TDLAxiomORoleDomain& ax ) { axiom ( asORoleDomain, ax.getRole(), ax.getDomain() ); }
+	virtual void visit ( const TDLAxiomDRoleDomain& ax ) { axiom ( asDRoleDomain, ax.getRole(), ax.getDomain() ); }
+	virtual void visit ( const TDLAxiomORoleRange& ax ) { axiom ( asORoleRange, ax.getRole(), ax.getRange() ); }
+	virtual void visit ( const TDLAxiomDRoleRange& ax ) { axiom ( asDRoleRange, ax.getRole(), ax.getRange() ); }
+	virtual void visit ( const TDLAxiomRoleTransitive& ax ) { axiom ( asRoleTransitive, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomRoleReflexive& ax ) { axiom ( asRoleReflexive, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomRoleIrreflexive& ax ) { axiom ( asRoleIrreflexive, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomRoleSymmetric& ax ) { axiom ( asRoleSymmetric, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomRoleAsymmetric& ax ) { axiom ( asRoleAsymmetric, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomORoleFunctional& ax ) { axiom ( asORoleFunctional, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomDRoleFunctional& ax ) { axiom ( asDRoleFunctional, ax.getRole() ); }
+	virtual void visit ( const TDLAxiomRoleInverseFunctional& ax ) { axiom ( asRoleInverseFunctional, ax.getRole() ); }
+
+	virtual void visit ( const TDLAxiomConceptInclusion& ax ) { axiom ( asConceptInclusion, ax.getSubC(), ax.getSupC() ); }
+	virtual void visit ( const TDLAxiomInstanceOf& ax ) { axiom ( asInstanceOf, ax.getIndividual(), ax.getC() ); }
+	virtual void visit ( const TDLAxiomRelatedTo& ax )
+		{ axiom ( asRelatedTo, ax.getIndividual(), ax.getRelation(), ax.getRelatedIndividual() ); }
+	virtual void visit ( const TDLAxiomRelatedToNot& ax )
+		{ axiom ( asRelatedToNot, ax.getIndividual(), ax.getRelation(), ax.getRelatedIndividual() ); }
+	virtual void visit ( const TDLAxiomValueOf& ax ) { axiom ( asValueOf, ax.getIndividual(), ax.getAttribute(), ax.getValue() ); }
+	virtual void visit ( const TDLAxiomValueOfNot& ax ) { axiom ( asValueOfNot, ax.getIndividual(), ax.getAttribute(), ax.getValue() ); }
+
+public:		// interface
+		/// init c'tor: write the header of the stream to O_; axioms are built by the expression manager EM
+	TAxiomStreamWriter ( std::ostream& o_, const TExpressionManager& em );
+		/// empty d'tor
+	virtual ~TAxiomStreamWriter ( void ) {}
+
+		/// write an axiom AX
+	void write ( const TDLAxiom* ax ) { ax->accept(*this); }
+		/// write all the used axioms of the ONTOLOGY
+	void write ( const TOntology& ontology );
+}; // TAxiomStreamWriter
+
+/// reader of the axioms from a binary axiom stream straight into an ontology
+class TAxiomStreamReader
+{
+protected:	// types
+		/// kinds of expressions to check the arguments
+	enum Kind
+	{
+		kConcept,
+		kIndividual,
+		kORole,
+		kORoleComplex,
+		kDRole,
+		kData,
+		kDataType,
+		kDataTypeName,
+		kDataValue,
+		kFacet,
+		kAny,
+	};
+		/// read expression together with its kind
+	struct Entry
+	{
+			/// expression itself
+		const TDLExpression* Expr;
+			/// kind of the expression
+		Kind kind;
+	}; // Entry
+
+protected:	// members
+		/// input stream
+	std::istream& i;
+		/// buffer for the stream
+	std::vector<char> Buffer;
+		/// current position in the buffer
+	const char* Pos;
+		/// end of the buffer content
+	const char* End;
+		/// ontology to fill
+	TOntology& Ontology;
+		/// expression manager of the ontology
+	TExpressionManager& EManager;
+		/// all the read expressions; indexed by ids
+	std::vector<Entry> Exprs;
+		/// arguments of the current axiom
+	std::vector<const TDLExpression*> Args;
+		/// string read last
+	std::string Str;
+
+protected:	// methods
+		/// fill the buffer from the stream; @return false iff there is nothing to read
+	bool fill ( void );
+		/// @return the next byte of the stream or EOF
+	int getByte ( void )
+	{
+		if ( Pos == End && !fill() )
+			return EOF;
+		return static_cast<unsigned char>(*Pos++);
+	}
+		/// @return the next number of the stream
+	std::uint64_t getNum ( void )
+	{
+		std::uint64_t ret = 0;
+		for ( unsigned int shift = 0; shift < 64; shift += 7 )
+		{
+			int c = getByte();
+			if ( c == EOF )
+				error("unexpected end of stream");
+			ret |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+			if ( (c & 0x80) == 0 )
+				return ret;
+		}
+		error("number is too long");
+		return 0;
+	}
+		/// @return the next string of the stream
+	const std::string& getString ( void );
+		/// report malformed stream
+	static void error ( const char* reason );
+
+		/// @return true iff an expression of the kind ACTUAL could be used where the kind EXPECTED is
+	static bool compatible ( Kind actual, Kind expected )
+	{
+		if ( actual == expected || expected == kAny )
+			return true;
+		switch ( expected )
+		{
+		case kORoleComplex:
+			return actual == kORole;
+		case kData:
+			return actual == kDataType || actual == kDataTypeName || actual == kDataValue;
+		case kDataType:
+			return actual == kDataTypeName;
+		default:
+			return false;
+		}
+	}
+		/// @return the expression of the KIND with the next id of the stream
+	const TDLExpression* getExpr ( Kind kind )
+	{
+		std::uint64_t id = getNum();
+		if ( id >= Exprs.size() )
+			error("unknown expression id");
+		if ( !compatible ( Exprs[id].kind, kind ) )
+			error("argument of a wrong kind");
+		return Exprs[id].Expr;
+	}
+		/// @return the expression of the type T and the KIND with the next id of the stream
+	template<class T>
+	const T* get ( Kind kind ) { return static_cast<const T*>(getExpr(kind)); }
+		/// read the arguments of the KIND into Args
+	void getArgs ( Kind kind )
+	{
+		Args.clear();
+		for ( std::uint64_t n = getNum(); n > 0; --n )
+			Args.push_back(getExpr(kind));
+	}
+		/// read the arguments of the KIND into the argument list of the expression manager
+	void getArgList ( Kind kind )
+	{
+		EManager.newArgList();
+		for ( std::uint64_t n = getNum(); n > 0; --n )
+			EManager.addArg(getExpr(kind));
+	}
+		/// @return the next number of the stream that fits an unsigned int
+	unsigned int getCardinality ( void )
+	{
+		std::uint64_t n = getNum();
+		if ( n > static_cast<unsigned int>(-1) )
+			error("cardinality is too large");
+		return static_cast<unsigned int>(n);
+	}
+
+		/// read the expression with a TAG and register it
+	void readExpression ( int tag );
+		/// @return the axiom with a TAG
+	TDLAxiom* readAxiom ( int tag );
+
+public:		// interface
+		/// init c'tor: read the header of the stream I_; the axioms will be added to the ONTOLOGY
+	TAxiomStreamReader ( std::istream& i_, TOntology& ontology );
+		/// no copy c'tor
+	TAxiomStreamReader ( const TAxiomStreamReader& ) = delete;
+		/// no assignment
+	TAxiomStreamReader& operator = ( const TAxiomStreamReader& ) = delete;
+
+		/// read all the axioms to the ontology; nothing is added if the stream is malformed. @return number of read axioms
+	size_t read ( void );
+}; // TAxiomStreamReader
+
+#endif
@@ -19,50 +19,27 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef TBRANCHINGCONTEXT_H
 #define TBRANCHINGCONTEXT_H
 
+#include <vector>
+
 #include "ConceptWithDep.h"
+#include "fpp_assert.h"
 
 class DlCompletionTree;
+class DlCompletionTreeArc;
 
-	/// class for saving branching context of a Reasoner
-class BranchingContext
+	/// kinds of the branching contexts
+enum BCKind
 {
-public:		// members
-		/// currently processed node
-	DlCompletionTree* curNode;
-		/// currently processed concept
-	ConceptWDep curConcept;
-		/// positions of the Used members
-	size_t pUsedIndex, nUsedIndex;
-		/// size of a session GCIs vector
-	size_t SGsize;
-		/// dependences for branching clashes
-	DepSet branchDep;
-
-public:		// interface
-		/// empty c'tor
-	BranchingContext ( void )
-		: curNode{nullptr}
-		, curConcept{bpINVALID}
-		, pUsedIndex{0}
-		, nUsedIndex{0}
-		, SGsize{0}
-		, branchDep{}
-		{}
-		/// no copy c'tor
-	BranchingContext ( const BranchingContext& ) = delete;
-		/// no assignment
-	BranchingContext& operator = ( const BranchingContext& ) = delete;
-		/// empty d'tor
-	virtual ~BranchingContext ( void ) {}
-
-		/// init indices (if necessary)
-	virtual void init ( void ) {}
-		/// give the next branching alternative
-	virtual void nextOption ( void ) {}
-}; // BranchingContext
-
-		/// branching context for the OR operations
-class BCOr: public BranchingContext
+	bckOr,		// OR operations
+	bckNN,		// NN-rule
+	bckLE,		// LE operations
+	bckTopLE,	// LE operations with the top role
+	bckChoose,	// Choose-rule
+	bckBarrier,	// barrier
+};
+
+		/// data of the branching context for the OR operations
+class BCOr
 {
 public:		// types
 		/// short OR indexes
@@ -78,13 +55,11 @@ public:		// members
 
 public:		// interface
 		/// empty c'tor
-	BCOr ( void ) : BranchingContext{}, branchIndex{0} {}
-		/// empty d'tor
-	virtual ~BCOr ( void ) {}
+	BCOr ( void ) : branchIndex{0} {}
 		/// init branch index
-	virtual void init ( void ) { branchIndex = 0; }
+	void init ( void ) { branchIndex = 0; }
 		/// give the next branching alternative
-	virtual void nextOption ( void ) { ++branchIndex; }
+	void nextOption ( void ) { ++branchIndex; }
 
 	// access to the fields
 
@@ -96,18 +71,8 @@ public:		// interface
 	or_iterator orCur ( void ) const { return orBeg() + branchIndex; }
 }; // BCOr
 
-	/// branching context for the Choose-rule
-class BCChoose: public BranchingContext
-{
-public:		// interface
-		/// empty c'tor
-	BCChoose ( void ) : BranchingContext{} {}
-		/// empty d'tor
-	virtual ~BCChoose ( void ) {}
-}; // BCChoose
-
-	/// branching context for the NN-rule
-class BCNN: public BranchingContext
+		/// data of the branching context for the NN-rule
+class BCNN
 {
 public:		// members
 		/// the value of M used in the NN rule
@@ -115,13 +80,11 @@ public:		// members
 
 public:		// interface
 		/// empty c'tor
-	BCNN ( void ) : BranchingContext{}, value{0} {}
-		/// empty d'tor
-	virtual ~BCNN ( void ) {}
+	BCNN ( void ) : value{0} {}
 		/// init value
-	virtual void init ( void ) { value = 1; }
+	void init ( void ) { value = 1; }
 		/// give the next branching alternative
-	virtual void nextOption ( void ) { ++value; }
+	void nextOption ( void ) { ++value; }
 
 	// access to the fields
 
@@ -129,9 +92,9 @@ public:		// interface
 	bool noMoreNNOptions ( unsigned int n ) const { return value > n; }
 }; // BCNN
 
-	/// branching context for the LE operations
+		/// data of the branching context for the LE operations
 template<class T>
-class BCLE: public BranchingContext
+class BCLE
 {
 public:		// types
 		/// Cardinality Restriction index type
@@ -150,11 +113,9 @@ public:		// members
 
 public:		// interface
 		/// empty c'tor
-	BCLE ( void ) : BranchingContext{}, toIndex{0}, fromIndex{0} {}
-		/// empty d'tor
-	virtual ~BCLE ( void ) {}
+	BCLE ( void ) : toIndex{0}, fromIndex{0} {}
 		/// init indices
-	virtual void init ( void )
+	void init ( void )
 	{
 		toIndex = 0;
 		fromIndex = 0;
@@ -162,7 +123,7 @@ public:		// interface
 		/// correct fromIndex after changing
 	void resetMCI ( void ) { fromIndex = (CRIndex)ItemsToMerge.size()-1; }
 		/// give the next branching alternative
-	virtual void nextOption ( void )
+	void nextOption ( void )
 	{
 		--fromIndex;	// get new merge candidate
 		if ( fromIndex == toIndex )	// nothing more can be mergeable to BI node
@@ -182,14 +143,96 @@ public:		// interface
 	bool noMoreLEOptions ( void ) const { return fromIndex <= toIndex; }
 }; // BCLE
 
-	/// branching context for the barrier
-class BCBarrier: public BranchingContext
+	/**
+	 * Context for saving branching state of a Reasoner: the common part and
+	 * the data of the every kind of the rule. The context is a slot of the
+	 * stack that is re-used by the rules of all kinds, so the data are kept
+	 * side by side instead of a union: the vectors of the data keep their
+	 * memory whatever rule used the slot last. The kind of the rule is the
+	 * tag that selects the relevant data.
+	 */
+class BranchingContext
 {
+protected:	// members
+		/// kind of the rule that created the context
+	BCKind Kind;
+		/// data of the OR operations
+	BCOr Or;
+		/// data of the NN-rule
+	BCNN NN;
+		/// data of the LE operations
+	BCLE<DlCompletionTreeArc> LE;
+		/// data of the LE operations with the top role
+	BCLE<DlCompletionTree> TopLE;
+
+public:		// members
+		/// currently processed node
+	DlCompletionTree* curNode;
+		/// currently processed concept
+	ConceptWDep curConcept;
+		/// positions of the Used members
+	size_t pUsedIndex, nUsedIndex;
+		/// size of a session GCIs vector
+	size_t SGsize;
+		/// dependences for branching clashes
+	DepSet branchDep;
+
 public:		// interface
 		/// empty c'tor
-	BCBarrier ( void ) : BranchingContext() {}
-		/// empty d'tor
-	virtual ~BCBarrier ( void ) {}
-}; // BCBarrier
+	BranchingContext ( void )
+		: Kind{bckBarrier}
+		, curNode{nullptr}
+		, curConcept{bpINVALID}
+		, pUsedIndex{0}
+		, nUsedIndex{0}
+		, SGsize{0}
+		, branchDep{}
+		{}
+		/// no copy c'tor
+	BranchingContext ( const BranchingContext& ) = delete;
+		/// no assignment
+	BranchingContext& operator = ( const BranchingContext& ) = delete;
+
+		/// @return the kind of the context
+	BCKind getKind ( void ) const { return Kind; }
+		/// init the context for the rule of the given KIND
+	void init ( BCKind kind )
+	{
+		Kind = kind;
+		switch ( Kind )
+		{
+		case bckOr:		Or.init(); break;
+		case bckNN:		NN.init(); break;
+		case bckLE:		LE.init(); break;
+		case bckTopLE:	TopLE.init(); break;
+		default:		break;
+		}
+	}
+		/// give the next branching alternative
+	void nextOption ( void )
+	{
+		switch ( Kind )
+		{
+		case bckOr:		Or.nextOption(); break;
+		case bckNN:		NN.nextOption(); break;
+		case bckLE:		LE.nextOption(); break;
+		case bckTopLE:	TopLE.nextOption(); break;
+		default:		break;
+		}
+	}
+
+	// access to the data of the particular kind
+
+		/// @return data of the OR operations
+	BCOr& getOr ( void ) { fpp_assert ( Kind == bckOr ); return Or; }
+		/// @return data of the OR operations
+	const BCOr& getOr ( void ) const { fpp_assert ( Kind == bckOr ); return Or; }
+		/// @return data of the NN-rule
+	BCNN& getNN ( void ) { fpp_assert ( Kind == bckNN ); return NN; }
+		/// @return data of the LE operations
+	BCLE<DlCompletionTreeArc>& getLE ( void ) { fpp_assert ( Kind == bckLE ); return LE; }
+		/// @return data of the LE operations with the top role
+	BCLE<DlCompletionTree>& getTopLE ( void ) { fpp_assert ( Kind == bckTopLE ); return TopLE; }
+}; // BranchingContext
 
 #endif
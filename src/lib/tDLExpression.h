@@ -257,10 +257,12 @@ protected:	// members
 	std::string Name;
 		/// translated version of it
 	TNamedEntry* entry;
+		/// dense id of the entity; given by the expression manager that owns it
+	unsigned int Id;
 
 public:		// interface
 		/// c'tor: initialise name
-	TNamedEntity ( const std::string& name ) : Name(name), entry(nullptr) {}
+	TNamedEntity ( const std::string& name ) : Name(name), entry(nullptr), Id(0) {}
 		/// empty d'tor
 	virtual ~TNamedEntity ( void ) {}
 
@@ -268,6 +270,10 @@ public:		// interface
 	const char* getName ( void ) const { return Name.c_str(); }
 		/// get access to the element itself
 	const TNamedEntity* getEntity ( void ) const { return this; }
+		/// get the dense id of the entity; different entities of one expression manager have different ids
+	unsigned int getId ( void ) const { return Id; }
+		/// set the dense id of the entity
+	void setId ( unsigned int id ) { Id = id; }
 
 		/// set entry
 	void setEntry ( TNamedEntry* e ) { entry = e; }
@@ -0,0 +1,104 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TDEADLINE_H
+#define TDEADLINE_H
+
+#include <atomic>
+#include <chrono>
+
+#include "eFPPTimeout.h"
+#include "globaldef.h"
+
+/**
+ * Wall-clock deadline of the current query together with the cooperative
+ * interrupt flag. Both are checked by the long-running loops of the reasoner,
+ * that throw EFPPTimeout as soon as the deadline has passed or the query was
+ * interrupted. The interrupt could be set from any thread.
+ */
+class TDeadline
+{
+protected:	// types
+		/// clock to measure the wall-clock time
+	typedef std::chrono::steady_clock Clock;
+
+protected:	// members
+		/// time point of the deadline
+	Clock::time_point Time;
+		/// true iff the deadline is set
+	std::atomic<bool> Set;
+		/// true iff the current query was interrupted
+	std::atomic<bool> Interrupted;
+
+public:		// interface
+		/// empty c'tor: no deadline
+	TDeadline ( void ) : Set(false), Interrupted(false) {}
+		/// copy c'tor
+	TDeadline ( const TDeadline& d ) : Time(d.Time), Set(d.Set.load()), Interrupted(d.Interrupted.load()) {}
+		/// assignment
+	TDeadline& operator = ( const TDeadline& d )
+	{
+		Time = d.Time;
+		Set = d.Set.load();
+		Interrupted = d.Interrupted.load();
+		return *this;
+	}
+
+		/// set the deadline to MS milliseconds from now; 0 means no deadline. Keeps the interrupt flag
+	void arm ( unsigned long ms )
+	{
+		Set = false;
+		if ( ms == 0 )
+			return;
+		Time = Clock::now() + std::chrono::milliseconds(ms);
+		Set = true;
+	}
+		/// set the deadline to MS milliseconds from now; 0 means no deadline. Clears the interrupt flag
+	void set ( unsigned long ms )
+	{
+		Interrupted = false;
+		arm(ms);
+	}
+		/// remove the deadline and clear the interrupt flag
+	void clear ( void ) { set(0); }
+		/// interrupt the current query
+	void interrupt ( void ) { Interrupted = true; }
+
+		/// @return true iff the deadline is set
+	bool isSet ( void ) const { return Set; }
+		/// @return true iff the deadline has passed or the query was interrupted
+	bool expired ( void ) const { return Interrupted || ( Set && Clock::now() >= Time ); }
+		/// @return milliseconds left before the deadline; 0 if it has passed or is not set
+	unsigned long remaining ( void ) const
+	{
+		if ( !Set || Interrupted )
+			return 0;
+		Clock::time_point now = Clock::now();
+		if ( now >= Time )
+			return 0;
+		return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(Time-now).count());
+	}
+		/// throw EFPPTimeout if the deadline has passed or the query was interrupted
+	void check ( void ) const
+	{
+		if ( unlikely(expired()) )
+			throw EFPPTimeout();
+	}
+}; // TDeadline
+
+#endif
@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define TDEPSET_H
 
 #include <iosfwd>
+#include <vector>
 
 #include "fpp_assert.h"
 #include "growingArrayP.h"
@@ -226,6 +227,12 @@ public:		// interface
 	}
 		/// check the equivalence of the two dep-sets
 	bool operator == ( const TDepSet& ds ) const { return dep == ds.dep; }
+		/// add all the levels of the dep-set to LEVELS, the latest first
+	void getLevels ( std::vector<unsigned int>& levels ) const
+	{
+		for ( TDepSetElement* p = dep; p; p = p->tail() )
+			levels.push_back(p->level());
+	}
 
 		/// Adds given dep-set to current dep-set
 	void add ( const TDepSet& toAdd ) { dep = dep ? dep->merge(toAdd.dep) : toAdd.dep; }
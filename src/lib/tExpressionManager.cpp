@@ -19,7 +19,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "tExpressionManager.h"
 
 TExpressionManager :: TExpressionManager ( void )
-	: CTop(new TDLConceptTop)
+	: NS_C(new TEntityCreator<TDLConceptName>(this))
+	, NS_I(new TEntityCreator<TDLIndividualName>(this))
+	, NS_OR(new TEntityCreator<TDLObjectRoleName>(this))
+	, NS_DR(new TEntityCreator<TDLDataRoleName>(this))
+	, nextEntityId(4)
+	, CTop(new TDLConceptTop)
 	, CBottom(new TDLConceptBottom)
 	, DTop(new TDLDataTop)
 	, DBottom(new TDLDataBottom)
@@ -27,6 +32,7 @@ TExpressionManager :: TExpressionManager ( void )
 	, ORBottom(new TDLObjectRoleBottom)
 	, DRTop(new TDLDataRoleTop)
 	, DRBottom(new TDLDataRoleBottom)
+	, TransientStart(0)
 	, InverseRoleCache(this)
 	, OneOfCache(this)
 {
@@ -59,6 +65,21 @@ TExpressionManager :: clear ( void )
 	for ( auto& expr: RefRecorder )
 		delete expr;
 	RefRecorder.clear();
+	for ( auto& expr: CacheRecorder )
+		delete expr;
+	CacheRecorder.clear();
+	TransientStart = 0;
+	// no entity of the manager is left apart from the top/bottom roles
+	nextEntityId = 4;
+}
+
+/// delete all the expressions recorded since the last keepRecorded() call
+void
+TExpressionManager :: releaseTransient ( void )
+{
+	for ( auto p = RefRecorder.begin()+(long)TransientStart, p_end = RefRecorder.end(); p != p_end; ++p )
+		delete *p;
+	RefRecorder.resize(TransientStart);
 }
 
 /// clear the TNamedEntry cache for all elements of all name-sets
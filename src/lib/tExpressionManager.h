@@ -29,6 +29,28 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 class TExpressionManager
 {
 protected:	// types
+		/// creator of the named entities that gives them the dense ids of the manager
+	template<class T>
+	class TEntityCreator: public TNameCreator<T>
+	{
+	protected:	// members
+			/// host expression manager
+		TExpressionManager* pManager;
+
+	public:		// interface
+			/// init c'tor
+		TEntityCreator ( TExpressionManager* p ) : TNameCreator<T>(), pManager(p) {}
+			/// empty d'tor
+		virtual ~TEntityCreator ( void ) {}
+
+			/// create new entity with the next free id
+		virtual T* makeEntry ( const std::string& name ) const
+		{
+			T* entity = new T(name);
+			entity->setId(pManager->newEntityId());
+			return entity;
+		}
+	}; // TEntityCreator
 		/// cache for the one-of expressions
 	class TOneOfCache: public THeadTailCache<TDLConceptExpression, const TDLIndividualExpression>
 	{
@@ -81,6 +103,8 @@ protected:	// members
 	TNameSet<TDLDataRoleName> NS_DR;
 		/// nameset for data types
 	TDataTypeManager NS_DT;
+		/// next free entity id; ids 0..3 are kept for the top/bottom roles
+	unsigned int nextEntityId;
 
 		/// n-ary queue for arguments
 	TNAryQueue<const TDLExpression> ArgQueue;
@@ -104,6 +128,10 @@ protected:	// members
 
 		/// record all the references
 	std::vector<TDLExpression*> RefRecorder;
+		/// record all the references created by the caches (never released before clear())
+	std::vector<TDLExpression*> CacheRecorder;
+		/// index of the 1st recorded reference that is not yet used by any kept axiom
+	size_t TransientStart;
 
 		/// cache for the role inverses
 	TInverseRoleCache InverseRoleCache;
@@ -111,9 +139,14 @@ protected:	// members
 	TOneOfCache OneOfCache;
 
 protected:	// methods
+		/// @return new dense id for the entity of the manager
+	unsigned int newEntityId ( void ) { return nextEntityId++; }
 		/// record the reference; @return the argument
 	template<class T>
 	T* record ( T* arg ) { RefRecorder.push_back(arg); return arg; }
+		/// record the reference created by a cache; @return the argument
+	template<class T>
+	T* recordCached ( T* arg ) { CacheRecorder.push_back(arg); return arg; }
 
 public:		// interface
 		/// empty c'tor
@@ -126,19 +159,35 @@ public:		// interface
 		/// clear the TNamedEntry cache for all elements of all name-sets
 	void clearNameCache ( void );
 
+	// transient expressions support (used by the streaming load)
+
+		/// mark all the recorded expressions as kept: they will never be released before clear()
+	void keepRecorded ( void ) { TransientStart = RefRecorder.size(); }
+		/// delete all the expressions recorded since the last keepRecorded() call
+	void releaseTransient ( void );
+
 	// top/bottom roles
 
 		/// set Top/Bot properties
 	void setTopBottomRoles ( const char* topORoleName, const char* botORoleName, const char* topDRoleName, const char* botDRoleName )
 	{
+		// these roles survive clear(), so they have the ids reserved for them
+		TDLObjectRoleName* oTop = new TDLObjectRoleName(topORoleName);
+		TDLObjectRoleName* oBot = new TDLObjectRoleName(botORoleName);
+		TDLDataRoleName* dTop = new TDLDataRoleName(topDRoleName);
+		TDLDataRoleName* dBot = new TDLDataRoleName(botDRoleName);
+		oTop->setId(0);
+		oBot->setId(1);
+		dTop->setId(2);
+		dBot->setId(3);
 		delete ORTop;
-		ORTop = new TDLObjectRoleName(topORoleName);
+		ORTop = oTop;
 		delete ORBottom;
-		ORBottom = new TDLObjectRoleName(botORoleName);
+		ORBottom = oBot;
 		delete DRTop;
-		DRTop = new TDLDataRoleName(topDRoleName);
+		DRTop = dTop;
 		delete DRBottom;
-		DRBottom = new TDLDataRoleName(botDRoleName);
+		DRBottom = dBot;
 	}
 		/// @return true iff R is a top object role
 	bool isUniversalRole ( const TDLObjectRoleExpression* R ) const { return R == ORTop; }
@@ -336,7 +385,7 @@ public:		// interface
 inline TDLObjectRoleExpression*
 TExpressionManager::TInverseRoleCache::build ( const TDLObjectRoleExpression* tail )
 {
-	return pManager->record(new TDLObjectRoleInverse(tail));
+	return pManager->recordCached(new TDLObjectRoleInverse(tail));
 }
 
 inline TDLConceptExpression*
@@ -344,7 +393,7 @@ TExpressionManager::TOneOfCache::build ( const TDLIndividualExpression* tail )
 {
 	pManager->newArgList();
 	pManager->addArg(tail);
-	return pManager->record(new TDLConceptOneOf(pManager->getArgList()));
+	return pManager->recordCached(new TDLConceptOneOf(pManager->getArgList()));
 }
 
 
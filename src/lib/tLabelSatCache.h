@@ -0,0 +1,102 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TLABELSATCACHE_H
+#define TLABELSATCACHE_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "BiPointer.h"
+#include "modelCacheInterface.h"
+
+/**
+ * Cache of the satisfiability status of the node labels. The key is the
+ * sorted set of concepts of a label; the value is a model cache built by a
+ * separate test of the conjunction of these concepts, so it does not depend
+ * on a particular completion tree and remains valid across the tests of
+ * a session. A cache is built only for a label that was seen before.
+ */
+class TLabelSatCache
+{
+public:		// types
+		/// sorted set of concepts of a label
+	typedef std::vector<BipolarPointer> Label;
+
+		/// cached label
+	struct Entry
+	{
+			/// number of times the label was looked up
+		unsigned int nSeen;
+			/// model cache of the label; nullptr if not built yet
+		const modelCacheInterface* Cache;
+
+			/// empty c'tor
+		Entry ( void ) : nSeen(0), Cache(nullptr) {}
+	}; // Entry
+
+protected:	// types
+		/// hash of a label
+	struct LabelHash
+	{
+		size_t operator() ( const Label& label ) const
+		{
+			size_t h = label.size();
+			for ( const auto& C: label )
+				h ^= std::hash<BipolarPointer>()(C) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	}; // LabelHash
+
+protected:	// members
+		/// all the entries
+	std::unordered_map<Label, Entry, LabelHash> Map;
+		/// maximal number of the entries
+	size_t Capacity;
+
+public:		// interface
+		/// init c'tor
+	TLabelSatCache ( size_t capacity ) : Capacity(capacity) {}
+		/// no copy c'tor
+	TLabelSatCache ( const TLabelSatCache& ) = delete;
+		/// no assignment
+	TLabelSatCache& operator = ( const TLabelSatCache& ) = delete;
+		/// d'tor
+	~TLabelSatCache ( void ) { clear(); }
+
+		/// @return the entry of the LABEL; create an empty one if necessary
+	Entry& get ( const Label& label )
+	{
+		// start from scratch when the cache is full
+		if ( Map.size() >= Capacity && Map.find(label) == Map.end() )
+			clear();
+		return Map[label];
+	}
+		/// remove all the entries
+	void clear ( void )
+	{
+		for ( auto& p: Map )
+			delete p.second.Cache;
+		Map.clear();
+	}
+		/// @return the number of the entries
+	size_t size ( void ) const { return Map.size(); }
+}; // TLabelSatCache
+
+#endif
@@ -19,8 +19,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef TNAMESET_H
 #define TNAMESET_H
 
+#include <cstdint>
+#include <cstring>
 #include <string>
-#include <map>
+#include <vector>
 
 /// base class for creating Named Entries; template parameter should be derived from TNamedEntry
 template<class T>
@@ -37,25 +39,84 @@ public:		// interface
 }; // TNameCreator
 
 
-/// Implementation of NameSets by binary trees; template parameter should be derived from TNamedEntry
+/**
+ * Implementation of NameSets by a hash table with linear probing;
+ * template parameter should be derived from TNamedEntry. The names are
+ * kept only by the entries themselves; the table slots refer to them.
+ */
 template<class T>
 class TNameSet
 {
 protected:	// types
+		/// slot of the hash table; empty iff Value is NULL
+	struct Slot
+	{
+			/// name of the entry; owned by the entry
+		const char* Key;
+			/// length of the name
+		size_t Length;
+			/// hash value of the name
+		size_t Hash;
+			/// the entry itself
+		T* Value;
+	}; // Slot
 		/// base type
-	typedef std::map <std::string, T*> NameTree;
+	typedef std::vector<Slot> NameTable;
 
 protected:	// members
-		/// Base holding all names
-	NameTree Base;
+		/// Base holding all names; its size is a power of 2
+	NameTable Base;
+		/// number of entries
+	size_t nEntries;
 		/// creator of new name
 	TNameCreator<T>* Creator;
 
+protected:	// methods
+		/// @return hash value of the name ID (FNV-1a)
+	static size_t hash ( const std::string& id )
+	{
+		std::uint64_t h = 14695981039346656037ULL;
+		for ( auto c: id )
+		{
+			h ^= static_cast<unsigned char>(c);
+			h *= 1099511628211ULL;
+		}
+		return static_cast<size_t>(h);
+	}
+		/// @return mask for the index of a slot
+	size_t mask ( void ) const { return Base.size() - 1; }
+		/// @return index of the slot with a name ID that has hash value H or of the empty slot where it should be
+	size_t find ( const std::string& id, size_t h ) const
+	{
+		size_t i = h & mask();
+		for ( ; Base[i].Value != nullptr; i = (i+1) & mask() )
+			if ( Base[i].Hash == h && Base[i].Length == id.size() && std::memcmp ( Base[i].Key, id.data(), id.size() ) == 0 )
+				break;
+		return i;
+	}
+		/// put SLOT into the first empty place for it
+	void place ( const Slot& slot )
+	{
+		size_t i = slot.Hash & mask();
+		while ( Base[i].Value != nullptr )
+			i = (i+1) & mask();
+		Base[i] = slot;
+	}
+		/// make the table twice as large
+	void grow ( void )
+	{
+		NameTable old ( 2*Base.size(), Slot{nullptr,0,0,nullptr} );
+		old.swap(Base);
+		for ( const auto& slot: old )
+			if ( slot.Value != nullptr )
+				place(slot);
+	}
+
 public:		// interface
 		/// c'tor (empty)
-	TNameSet ( void ) : Creator(new TNameCreator<T>) {}
+	TNameSet ( void ) : Base(16,Slot{nullptr,0,0,nullptr}), nEntries(0), Creator(new TNameCreator<T>) {}
 		/// c'tor (with given Name Creating class)
-	TNameSet ( TNameCreator<T>* p ) : Creator(p) {}
+	TNameSet ( TNameCreator<T>* p ) : Base(16,Slot{nullptr,0,0,nullptr}), nEntries(0), Creator(p) {}
 		/// no copy c'tor
 	TNameSet ( const TNameSet& ) = delete;
 		/// no assignment
@@ -64,16 +125,21 @@ public:		// interface
 	virtual ~TNameSet ( void ) { clear(); delete Creator; }
 
 		/// return pointer to existing id or NULL if no such id defined
-	T* get ( const std::string& id ) const
-	{
-		auto p = Base.find(id);
-		return p == Base.end() ? nullptr : p->second;
-	}
+	T* get ( const std::string& id ) const { return Base[find(id,hash(id))].Value; }
 		/// unconditionally add new element with name ID to the set; return new element
 	T* add ( const std::string& id )
 	{
 		T* pne = Creator->makeEntry(id);
-		Base[id] = pne;
+		size_t h = hash(id);
+		size_t i = find(id,h);
+		bool replace = Base[i].Value != nullptr;
+		// the entry is named ID, so its name is the key
+		Base[i] = Slot{ pne->getName(), id.size(), h, pne };
+		if ( replace )
+			return pne;
+		// keep the load factor below 3/4
+		if ( 4 * ++nEntries > 3 * Base.size() )
+			grow();
 		return pne;
 	}
 		/// Insert id to the nameset (if necessary); @return pointer to id structure created by external creator
@@ -87,27 +153,37 @@ public:		// interface
 		/// remove given entry from the set
 	void remove ( const std::string& id )
 	{
-		auto p = Base.find(id);
+		size_t i = find(id,hash(id));
 
-		if ( p != Base.end () )	// found such Id
+		if ( Base[i].Value == nullptr )	// no such Id
+			return;
+
+		delete Base[i].Value;
+		Base[i].Value = nullptr;
+		--nEntries;
+		// re-place the rest of the probe sequence to keep it contiguous
+		for ( size_t j = (i+1) & mask(); Base[j].Value != nullptr; j = (j+1) & mask() )
 		{
-			delete p->second;
-			Base.erase(p);
+			Slot slot = Base[j];
+			Base[j].Value = nullptr;
+			place(slot);
 		}
 	}
 		/// clear name set
 	void clear ( void )
 	{
 		for ( auto& p: Base )
-			delete p.second;
-
-		Base.clear();
+		{
+			delete p.Value;
+			p.Value = nullptr;
+		}
+		nEntries = 0;
 	}
 		/// clear the Entry field in all entities
 	template <class U>
 	friend void clearEntriesCache ( TNameSet<U>& ns );
 		/// get size of a name set
-	size_t size ( void ) const { return Base.size(); }
+	size_t size ( void ) const { return nEntries; }
 }; // TNameSet
 
 /// clear the Entry field in all entities
@@ -115,8 +191,9 @@ public:		// interface
 template <class T>
 void clearEntriesCache ( TNameSet<T>& ns )
 {
-	for ( auto& bind: ns.Base )
-		bind.second->setEntry(nullptr);
+	for ( auto& slot: ns.Base )
+		if ( slot.Value != nullptr )
+			slot.Value->setEntry(nullptr);
 }
 
 #endif
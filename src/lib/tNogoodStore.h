@@ -0,0 +1,129 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TNOGOODSTORE_H
+#define TNOGOODSTORE_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "BiPointer.h"
+
+/**
+ * Store of the learned nogoods: sets of concepts that can't appear together
+ * in the label of the root node of a test. A nogood is learned from a clash
+ * set which branching points are all disjunction choices in the root node,
+ * so the clash follows from the chosen concepts and the initial concepts of
+ * the test. It remains valid in every test which initial concepts include
+ * the ones of the test the nogood was learned in.
+ */
+class TNogoodStore
+{
+public:		// types
+		/// set of concepts
+	typedef std::vector<BipolarPointer> ConceptSet;
+		/// list of nogood indices
+	typedef std::vector<unsigned int> IndexList;
+
+		/// learned nogood
+	struct Nogood
+	{
+			/// initial concepts of the test the nogood was learned in
+		BipolarPointer P, Q;
+			/// concepts that can't be together in the root label (sorted)
+		ConceptSet Concepts;
+	}; // Nogood
+
+protected:	// members
+		/// all the nogoods
+	std::vector<Nogood> Nogoods;
+		/// map between the concepts and the nogoods that contain them
+	std::unordered_map<BipolarPointer, IndexList> Index;
+		/// maximal number of the nogoods
+	size_t Capacity;
+		/// initial concepts of the current test
+	BipolarPointer TestP, TestQ;
+		/// true iff nogoods are learned and used in the current test
+	bool active;
+
+protected:	// methods
+		/// @return true iff P is one of the initial concepts of the current test
+	bool inTest ( BipolarPointer p ) const { return p == bpTOP || p == TestP || p == TestQ; }
+
+public:		// interface
+		/// init c'tor
+	TNogoodStore ( size_t capacity ) : Capacity(capacity), TestP(bpTOP), TestQ(bpTOP), active(false) {}
+		/// no copy c'tor
+	TNogoodStore ( const TNogoodStore& ) = delete;
+		/// no assignment
+	TNogoodStore& operator = ( const TNogoodStore& ) = delete;
+
+		/// start a test with the initial concepts P and Q
+	void startTest ( BipolarPointer p, BipolarPointer q )
+	{
+		TestP = p;
+		TestQ = q;
+		active = true;
+	}
+		/// don't use nogoods until the next startTest()
+	void stopTest ( void ) { active = false; }
+		/// @return true iff nogoods are used in the current test
+	bool isActive ( void ) const { return active; }
+
+		/// add a nogood with the CONCEPTS learned in the current test; @return true iff it is a new one
+	bool add ( ConceptSet& concepts )
+	{
+		std::sort ( concepts.begin(), concepts.end() );
+		concepts.erase ( std::unique ( concepts.begin(), concepts.end() ), concepts.end() );
+		// don't keep duplicates
+		for ( const auto& i: find(concepts.front()) )
+			if ( Nogoods[i].P == TestP && Nogoods[i].Q == TestQ && Nogoods[i].Concepts == concepts )
+				return false;
+		// start from scratch when the store is full
+		if ( Nogoods.size() >= Capacity )
+			clear();
+		unsigned int n = (unsigned int)Nogoods.size();
+		Nogoods.push_back ( Nogood { TestP, TestQ, concepts } );
+		for ( const auto& C: concepts )
+			Index[C].push_back(n);
+		return true;
+	}
+		/// @return indices of the nogoods that contain the concept C
+	const IndexList& find ( BipolarPointer C ) const
+	{
+		static const IndexList empty;
+		auto p = Index.find(C);
+		return p == Index.end() ? empty : p->second;
+	}
+		/// @return the nogood with the index I
+	const Nogood& operator [] ( unsigned int i ) const { return Nogoods[i]; }
+		/// @return true iff the nogood N holds in the current test
+	bool applicable ( const Nogood& n ) const { return inTest(n.P) && inTest(n.Q); }
+
+		/// remove all the nogoods
+	void clear ( void )
+	{
+		Nogoods.clear();
+		Index.clear();
+	}
+		/// @return the number of the nogoods
+	size_t size ( void ) const { return Nogoods.size(); }
+}; // TNogoodStore
+
+#endif
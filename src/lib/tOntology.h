@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "globaldef.h"
 #include "tDLAxiom.h"
 #include "tExpressionManager.h"
+#include "tSignature.h"
 
 /// define ontology as a set of axioms
 class TOntology
@@ -62,6 +63,8 @@ public:		// interface
 	{
 		p->setId(++axiomId);
 		Axioms.push_back(p);
+		// expressions used in the axiom should live as long as the ontology
+		EManager.keepRecorded();
 		changed = true;
 		return p;
 	}
@@ -102,6 +105,8 @@ public:		// interface
 
 		/// get access to an expression manager
 	TExpressionManager* getExpressionManager ( void ) { return &EManager; }
+		/// get RO access to an expression manager
+	const TExpressionManager* getExpressionManager ( void ) const { return &EManager; }
 
 	// access to axioms
 
@@ -382,6 +382,8 @@ public:		// interface
 		/// empty d'tor
 	virtual ~TOntologyLoader ( void ) {}
 
+		/// load a single axiom to a given KB (used in the streaming mode)
+	void loadAxiom ( const TDLAxiom& axiom ) { axiom.accept(*this); }
 		/// load ontology to a given KB
 	void visitOntology ( TOntology& ontology )
 	{
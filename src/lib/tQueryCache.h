@@ -0,0 +1,170 @@
+/* This file is part of the FaCT++ DL reasoner
+Copyright (C) 2015 by Dmitry Tsarkov
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef TQUERYCACHE_H
+#define TQUERYCACHE_H
+
+#include <list>
+#include <unordered_map>
+
+#include "fpp_assert.h"
+#include "taxVertex.h"
+
+class TConcept;
+class TDLConceptExpression;
+
+/**
+ * Cache of the query concepts with the least recently used replacement.
+ * An entry keeps the concept that represents the query (together with
+ * its DAG entries) and the taxonomy vertex of a classified query. Both
+ * parts are only valid in the epochs they were created in: the query part
+ * of the DAG and the taxonomy are rebuilt from time to time.
+ */
+class TQueryCache
+{
+public:		// types
+		/// cached query
+	struct Entry
+	{
+			/// query concept (either a named one or a query concept of a TBox)
+		TConcept* Concept;
+			/// taxonomy vertex of a classified concept
+		TaxonomyVertex* Vertex;
+			/// epoch in which the query concept was created
+		unsigned int ConceptEpoch;
+			/// epoch in which the query was classified
+		unsigned int VertexEpoch;
+			/// true iff the vertex is owned by the entry
+		bool OwnVertex;
+
+			/// empty c'tor
+		Entry ( void ) : Concept(nullptr), Vertex(nullptr), ConceptEpoch(0), VertexEpoch(0), OwnVertex(false) {}
+			/// @return true iff the query concept is valid in the EPOCH
+		bool hasConcept ( unsigned int epoch ) const { return Concept != nullptr && ConceptEpoch == epoch; }
+			/// @return true iff the classification result is valid in the EPOCH
+		bool hasVertex ( unsigned int epoch ) const { return Vertex != nullptr && VertexEpoch == epoch; }
+			/// set the query CONCEPT created in the EPOCH
+		void setConcept ( TConcept* concept, unsigned int epoch ) { Concept = concept; ConceptEpoch = epoch; }
+			/// set the taxonomy VERTEX of the query, classified in the EPOCH; OWN means the vertex is passed to the entry
+		void setVertex ( TaxonomyVertex* vertex, unsigned int epoch, bool own )
+		{
+			clearVertex();
+			Vertex = vertex;
+			VertexEpoch = epoch;
+			OwnVertex = own;
+		}
+			/// forget the classification result
+		void clearVertex ( void )
+		{
+			if ( OwnVertex )
+				delete Vertex;
+			Vertex = nullptr;
+			OwnVertex = false;
+		}
+			/// forget everything
+		void clear ( void ) { clearVertex(); Concept = nullptr; }
+	}; // Entry
+
+protected:	// types
+		/// cached query together with its expression
+	typedef std::pair<const TDLConceptExpression*, Entry> QueryEntry;
+		/// list of the queries
+	typedef std::list<QueryEntry> QueryList;
+
+protected:	// members
+		/// cached queries; the most recently used first
+	QueryList Queries;
+		/// map between the expressions and the entries in the list
+	std::unordered_map<const TDLConceptExpression*, QueryList::iterator> Index;
+		/// maximal number of entries
+	size_t Capacity;
+		/// number of queries answered from the cache
+	unsigned long long nHits;
+		/// number of queries that required reasoning
+	unsigned long long nMisses;
+
+protected:	// methods
+		/// remove the least recently used entry
+	void evict ( void )
+	{
+		Queries.back().second.clear();
+		Index.erase(Queries.back().first);
+		Queries.pop_back();
+	}
+
+public:		// interface
+		/// init c'tor
+	TQueryCache ( size_t capacity ) : Capacity(capacity), nHits(0), nMisses(0) { fpp_assert ( capacity > 0 ); }
+		/// no copy c'tor
+	TQueryCache ( const TQueryCache& ) = delete;
+		/// no assignment
+	TQueryCache& operator = ( const TQueryCache& ) = delete;
+		/// d'tor
+	~TQueryCache ( void ) { clear(); }
+
+		/// @return the entry for the QUERY (a new one if the query is not cached); make it the most recently used
+	Entry& get ( const TDLConceptExpression* query )
+	{
+		auto p = Index.find(query);
+		if ( p != Index.end() )
+		{
+			Queries.splice ( Queries.begin(), Queries, p->second );
+			return p->second->second;
+		}
+		if ( Queries.size() >= Capacity )
+			evict();
+		Queries.push_front(QueryEntry(query,Entry()));
+		Index[query] = Queries.begin();
+		return Queries.front().second;
+	}
+		/// move the classification results valid in the epoch FROM to the epoch TO
+	void moveVertices ( unsigned int from, unsigned int to )
+	{
+		for ( auto& q: Queries )
+			if ( q.second.hasVertex(from) )
+				q.second.VertexEpoch = to;
+	}
+		/// remove all the entries
+	void clear ( void )
+	{
+		while ( !Queries.empty() )
+			evict();
+	}
+
+		/// set the maximal number of entries to CAPACITY
+	void setCapacity ( size_t capacity )
+	{
+		fpp_assert ( capacity > 0 );
+		Capacity = capacity;
+		while ( Queries.size() > Capacity )
+			evict();
+	}
+		/// @return the maximal number of entries
+	size_t getCapacity ( void ) const { return Capacity; }
+		/// @return the number of entries
+	size_t size ( void ) const { return Queries.size(); }
+
+		/// register a query answered from the cache (HIT is true) or by reasoning
+	void count ( bool hit ) { if ( hit ) ++nHits; else ++nMisses; }
+		/// @return number of queries answered from the cache
+	unsigned long long getNHits ( void ) const { return nHits; }
+		/// @return number of queries that required reasoning
+	unsigned long long getNMisses ( void ) const { return nMisses; }
+}; // TQueryCache
+
+#endif
@@ -19,62 +19,111 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef TSIGNATURE_H
 #define TSIGNATURE_H
 
-#include <set>
+#include <vector>
 #include <algorithm>
-#include <iterator>
+#include <cstdint>
 
 #include "tDLExpression.h"
 
-/// class to hold the signature of a module
+/**
+ * Class to hold the signature of a module. Entities are identified by their dense ids.
+ * Small signatures keep entities in a vector sorted by id. Once the signature is dense
+ * enough (i.e., a bit per possible id costs no more than a pointer per element), it
+ * switches to a bitset over the ids; elements are then kept in the insertion order.
+ */
 class TSignature
 {
 public:		// types
-		/// set of entities as a base underlying type os a signature
-	typedef std::set<const TNamedEntity*> BaseType;
+		/// vector of entities as a base underlying type of a signature
+	typedef std::vector<const TNamedEntity*> BaseType;
 		/// RO iterator over a set of entities
 	typedef BaseType::const_iterator iterator;
 
+protected:	// types
+		/// word of a bitset
+	typedef std::uint64_t Word;
+
 protected:	// members
-		/// set to keep all the elements in signature
-	BaseType Set;
+		/// all the elements of the signature; sorted by id unless bitset is in use
+	BaseType Elems;
+		/// bitset over the ids of the elements; empty for the small signatures
+	std::vector<Word> Bits;
+		/// number of changes of the signature; lets its users notice the change
+	unsigned int Version;
 		/// true if concept TOP-locality; false if concept BOTTOM-locality
 	bool topCLocality;
 		/// true if role TOP-locality; false if role BOTTOM-locality
 	bool topRLocality;
 
 protected:	// methods
+		/// number of bits in a word
+	static unsigned int wordBits ( void ) { return 64; }
+		/// min number of elements to switch to a bitset
+	static size_t minBitsetSize ( void ) { return 64; }
+		/// compare entities by their ids
+	static bool idLess ( const TNamedEntity* p, const TNamedEntity* q ) { return p->getId() < q->getId(); }
+
+		/// @return true iff the bitset representation is used
+	bool useBits ( void ) const { return !Bits.empty(); }
+		/// @return true iff bit ID is set
+	bool testBit ( unsigned int id ) const
+	{
+		size_t n = id / wordBits();
+		return n < Bits.size() && ( Bits[n] & (Word(1) << (id % wordBits())) ) != 0;
+	}
+		/// set bit ID
+	void setBit ( unsigned int id )
+	{
+		size_t n = id / wordBits();
+		if ( n >= Bits.size() )
+			Bits.resize ( n+1, 0 );
+		Bits[n] |= Word(1) << (id % wordBits());
+	}
+		/// clear bit ID
+	void clearBit ( unsigned int id ) { Bits[id / wordBits()] &= ~(Word(1) << (id % wordBits())); }
+		/// @return position of P in the sorted vector of elements
+	BaseType::iterator lowerBound ( const TNamedEntity* p ) { return std::lower_bound ( Elems.begin(), Elems.end(), p, idLess ); }
+		/// switch to the bitset if the (sorted) signature is dense enough
+	void checkDensity ( void )
+	{
+		if ( Elems.size() < minBitsetSize() || Elems.size() * wordBits() <= Elems.back()->getId() )
+			return;
+		Bits.assign ( Elems.back()->getId() / wordBits() + 1, 0 );
+		for ( iterator p = Elems.begin(), p_end = Elems.end(); p != p_end; ++p )
+			setBit((*p)->getId());
+	}
 		/// @return true if *THIS \subseteq SIG (\subset if IMPROPER = false )
 	bool subset ( const TSignature& sig, bool improper ) const
 	{
-		iterator p = Set.begin(), p_end = Set.end(), q = sig.Set.begin(), q_end = sig.Set.end();
-		bool proper = false;
-		while ( p != p_end && q != q_end )
+		if ( size() > sig.size() )
+			return false;
+		if ( useBits() && sig.useBits() )
+		{	// word-parallel check
+			for ( size_t i = 0, n = Bits.size(); i < n; ++i )
+				if ( Bits[i] & ~( i < sig.Bits.size() ? sig.Bits[i] : 0 ) )
+					return false;
+		}
+		else
 		{
-			if ( *p < *q )	// something in THIS doesn't exist in SIG
-				return false;
-			if ( *q < *p )
-				++q, proper = true;
-			else
-				++p, ++q;
+			for ( iterator p = begin(), p_end = end(); p != p_end; ++p )
+				if ( !sig.contains(*p) )
+					return false;
 		}
-		if ( p != p_end )	// extra stuff in THIS
-			return false;
-		// here THIS is empty
-		if ( q != q_end )	// there are extra elements in SIG
-			return improper;
-		// both are done; the answer depends on flags
-		return improper ? true : proper;
+		// here THIS is in SIG; the answer depends on flags
+		return improper || size() < sig.size();
 	}
 
 public:		// interface
 		/// empty c'tor
-	TSignature ( void ) : topCLocality(false), topRLocality(false) {}
+	TSignature ( void ) : Version(0), topCLocality(false), topRLocality(false) {}
 		/// copy c'tor
-	TSignature ( const TSignature& copy ) : Set(copy.Set), topCLocality(copy.topCLocality), topRLocality(copy.topRLocality) {}
-		/// assignment
+	TSignature ( const TSignature& copy ) : Elems(copy.Elems), Bits(copy.Bits), Version(0), topCLocality(copy.topCLocality), topRLocality(copy.topRLocality) {}
+		/// assignment; the version is not copied
 	TSignature& operator= ( const TSignature& copy )
 	{
-		Set = copy.Set;
+		++Version;
+		Elems = copy.Elems;
+		Bits = copy.Bits;
 		topCLocality = copy.topCLocality;
 		topRLocality = copy.topRLocality;
 		return *this;
@@ -85,24 +134,62 @@ public:		// interface
 	// add names to signature
 
 		/// add pointer to named object to signature
-	void add ( const TNamedEntity* p ) { Set.insert(p); }
-		/// add set of named entities to signature
-	void add ( const BaseType& aSet ) { Set.insert ( aSet.begin(), aSet.end() ); }
+	void add ( const TNamedEntity* p )
+	{
+		if ( useBits() )
+		{
+			if ( testBit(p->getId()) )
+				return;
+			++Version;
+			setBit(p->getId());
+			Elems.push_back(p);
+			return;
+		}
+		BaseType::iterator q = lowerBound(p);
+		if ( q != Elems.end() && *q == p )
+			return;
+		++Version;
+		Elems.insert ( q, p );
+		checkDensity();
+	}
 		/// add another signature to a given one
-	void add ( const TSignature& Sig ) { add(Sig.Set); }
+	void add ( const TSignature& Sig )
+	{
+		if ( useBits() && Sig.useBits() && Sig <= *this )	// nothing new
+			return;
+		for ( iterator p = Sig.begin(), p_end = Sig.end(); p != p_end; ++p )
+			add(*p);
+	}
 		/// remove given element from a signature
-	void remove ( const TNamedEntity* p ) { Set.erase(p); }
+	void remove ( const TNamedEntity* p )
+	{
+		if ( useBits() )
+		{
+			if ( !testBit(p->getId()) )
+				return;
+			++Version;
+			clearBit(p->getId());
+			Elems.erase ( std::find ( Elems.begin(), Elems.end(), p ) );
+			return;
+		}
+		BaseType::iterator q = lowerBound(p);
+		if ( q != Elems.end() && *q == p )
+		{
+			++Version;
+			Elems.erase(q);
+		}
+	}
 		/// set new locality polarity
-	void setLocality ( bool topC, bool topR ) { topCLocality = topC; topRLocality = topR; }
+	void setLocality ( bool topC, bool topR ) { ++Version; topCLocality = topC; topRLocality = topR; }
 		/// set new locality polarity
 	void setLocality ( bool top ) { setLocality ( top, top ); }
 
 	// comparison
 
 		/// check whether 2 signatures are the same
-	bool operator == ( const TSignature& sig ) const { return Set == sig.Set; }
+	bool operator == ( const TSignature& sig ) const { return size() == sig.size() && subset ( sig, /*improper=*/true ); }
 		/// check whether 2 signatures are different
-	bool operator != ( const TSignature& sig ) const { return Set != sig.Set; }
+	bool operator != ( const TSignature& sig ) const { return !(*this == sig); }
 		/// @return true if *THIS \subset SIG
 	bool operator < ( const TSignature& sig ) const { return subset ( sig, /*improper=*/false ); }
 		/// @return true if *THIS \subseteq SIG
@@ -112,7 +199,12 @@ public:		// interface
 		/// @return true if SIG \subseteq *THIS
 	bool operator >= ( const TSignature& sig ) const { return sig.subset ( *this, /*improper=*/true ); }
 		/// @return true iff signature contains given element
-	bool contains ( const TNamedEntity* p ) const { return Set.count(p) > 0; }
+	bool contains ( const TNamedEntity* p ) const
+	{
+		if ( useBits() )
+			return testBit(p->getId());
+		return std::binary_search ( Elems.begin(), Elems.end(), p, idLess );
+	}
 		/// @return true iff signature contains given element
 	bool contains ( const TDLExpression* p ) const
 	{
@@ -122,16 +214,35 @@ public:		// interface
 			return contains(inv->getOR());
 
 		return false;
+	}
+		/// @return true iff signature has common elements with SIG
+	bool intersects ( const TSignature& sig ) const
+	{
+		if ( useBits() && sig.useBits() )
+		{	// word-parallel check
+			for ( size_t i = 0, n = std::min ( Bits.size(), sig.Bits.size() ); i < n; ++i )
+				if ( Bits[i] & sig.Bits[i] )
+					return true;
+			return false;
+		}
+		const TSignature& small = size() < sig.size() ? *this : sig;
+		const TSignature& large = size() < sig.size() ? sig : *this;
+		for ( iterator p = small.begin(), p_end = small.end(); p != p_end; ++p )
+			if ( large.contains(*p) )
+				return true;
+		return false;
 	}
 		/// @return size of the signature
-	size_t size ( void ) const { return Set.size(); }
+	size_t size ( void ) const { return Elems.size(); }
 		/// clear the signature
-	void clear ( void ) { Set.clear(); }
+	void clear ( void ) { ++Version; Elems.clear(); Bits.clear(); }
+		/// @return the version of the signature; it changes with every change of the signature
+	unsigned int getVersion ( void ) const { return Version; }
 
 		/// RO access to the elements of signature
-	iterator begin ( void ) const { return Set.begin(); }
+	iterator begin ( void ) const { return Elems.begin(); }
 		/// RO access to the elements of signature
-	iterator end ( void ) const { return Set.end(); }
+	iterator end ( void ) const { return Elems.end(); }
 
 		/// @return true iff concepts are treated as TOPs
 	bool topCLocal ( void ) const { return topCLocality; }
@@ -143,11 +254,25 @@ public:		// interface
 	bool botRLocal ( void ) const { return !topRLocality; }
 }; // TSignature
 
+/// @return elements that are both in S1 and S2
 inline TSignature::BaseType
 intersect ( const TSignature& s1, const TSignature& s2 )
 {
 	TSignature::BaseType ret;
-	set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(), inserter(ret, ret.begin()));
+	for ( TSignature::iterator p = s1.begin(), p_end = s1.end(); p != p_end; ++p )
+		if ( s2.contains(*p) )
+			ret.push_back(*p);
+	return ret;
+}
+
+/// @return elements of S1 that are not in S2
+inline TSignature::BaseType
+difference ( const TSignature& s1, const TSignature& s2 )
+{
+	TSignature::BaseType ret;
+	for ( TSignature::iterator p = s1.begin(), p_end = s1.end(); p != p_end; ++p )
+		if ( !s2.contains(*p) )
+			ret.push_back(*p);
 	return ret;
 }
 
@@ -67,6 +67,8 @@ protected:	// members
 	bool checkValue;
 		/// flag to check whether the vertex is in use
 	bool inUse;
+		/// index of the vertex in the reachability index of its taxonomy; 0 if not indexed
+	unsigned int Index;
 
 protected:	// methods
 		/// indirect RW access to Links
@@ -135,6 +137,7 @@ public:
 	TaxonomyVertex ( void )
 		: sample(nullptr)
 		, inUse(true)
+		, Index(0)
 	{
 		initFlags();
 	}
@@ -208,6 +211,13 @@ public:
 		/// set the inUse value of the node
 	void setInUse ( bool value ) { inUse = value; }
 
+	// reachability index support
+
+		/// @return index of the vertex in the reachability index; 0 if the vertex is not indexed
+	unsigned int getIndex ( void ) const { return Index; }
+		/// set index of the vertex in the reachability index to I
+	void setIndex ( unsigned int i ) { Index = i; }
+
 	// output methods
 
 		/// print taxonomy vertex in format <equals parents children>